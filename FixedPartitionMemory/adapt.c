@@ -0,0 +1,151 @@
+#include "os_types.h"
+#include "log.h"
+#include "adapt.h"
+#include "partition.h"
+#include "memory.h"
+#include "kernel.h"
+#include "config.h"
+
+#define ADAPT_WEIGHT 16                      // 单个请求的权重 (整数衰减)
+#define ADAPT_MIN_WEIGHT (4 * ADAPT_WEIGHT)  // 至少相当于4个请求才做决定
+
+// 自适应状态位于当前内核上下文
+#define ADAPT (kernel_ctx_current()->adapt)
+
+void adapt_set_enabled(int enable) {
+    ADAPT.enabled = enable;
+}
+
+int adapt_is_enabled(void) {
+    return ADAPT.enabled;
+}
+
+void adapt_reset(void) {
+    memset(ADAPT.demand, 0, sizeof(ADAPT.demand));
+    memset(ADAPT.unmet, 0, sizeof(ADAPT.unmet));
+    memset(&ADAPT.stats, 0, sizeof(ADAPT.stats));
+    ADAPT.last_alloc_time = 0;
+    ADAPT.cooldown_until = 0;
+    ADAPT.split_votes = 0;
+    ADAPT.merge_votes = 0;
+}
+
+static uint32_t bucket_of(uint32_t size) {
+    uint32_t b = (size + ADAPT_GRANULARITY - 1) / ADAPT_GRANULARITY;
+    return b < ADAPT_BUCKETS ? b : ADAPT_BUCKETS - 1;
+}
+
+void adapt_record_request(uint32_t size, int satisfied) {
+    if (!ADAPT.enabled) return;
+
+    ADAPT.demand[bucket_of(size)] += ADAPT_WEIGHT;
+    if (satisfied) {
+        ADAPT.last_alloc_time = get_current_time();
+    } else if (get_total_free_memory() >= size) {
+        ADAPT.unmet[bucket_of(size)] += ADAPT_WEIGHT;
+    }
+}
+
+static uint32_t hist_total(const uint32_t* hist) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < ADAPT_BUCKETS; i++) total += hist[i];
+    return total;
+}
+
+// 加权分位数，返回对应的请求大小
+static uint32_t hist_quantile(const uint32_t* hist, uint32_t total, uint32_t pct) {
+    uint32_t target = (uint32_t)((uint64_t)total * pct / 100);
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < ADAPT_BUCKETS; i++) {
+        seen += hist[i];
+        if (seen > target) return i * ADAPT_GRANULARITY;
+    }
+    return (ADAPT_BUCKETS - 1) * ADAPT_GRANULARITY;
+}
+
+// 合并候选: 未满足请求的中位数大于所有空闲分区时，选和最小且足够大的相邻空闲分区对
+static int find_merge(uint32_t need) {
+    int best = -1;
+    uint32_t best_size = 0xFFFFFFFF;
+
+    if (need <= get_largest_free_block()) return -1;
+    for (uint32_t i = 1; i + 1 < partition_count; i++) {
+        uint32_t size = partition_table[i].size + partition_table[i + 1].size;
+        if (partition_table[i].state == PARTITION_FREE && partition_table[i + 1].state == PARTITION_FREE &&
+            size >= need && size < best_size) {
+            best = (int)i;
+            best_size = size;
+        }
+    }
+    return best;
+}
+
+// 拆分候选: 能容纳两个典型请求的最大空闲分区，且拆分后仍有分区能容纳大请求
+static int find_split(uint32_t typical, uint32_t large) {
+    int best = -1;
+
+    if (partition_count >= MAX_PARTITIONS) return -1;
+    for (uint32_t i = 1; i < partition_count; i++) {
+        const partition_t* part = &partition_table[i];
+        if (part->state != PARTITION_FREE || part->size < 2 * typical) continue;
+        if (best >= 0 && part->size <= partition_table[best].size) continue;
+
+        int large_left = part->size - typical >= large;
+        for (uint32_t j = 1; j < partition_count && !large_left; j++) {
+            large_left = j != i && partition_table[j].size >= large;
+        }
+        if (large_left) best = (int)i;
+    }
+    return best;
+}
+
+void adapt_tick(uint32_t now) {
+    if (!ADAPT.enabled || now % ADAPT_INTERVAL != 0) return;
+
+    ADAPT.stats.checks++;
+    for (uint32_t i = 0; i < ADAPT_BUCKETS; i++) {
+        ADAPT.demand[i] -= ADAPT.demand[i] >> ADAPT_DECAY_SHIFT;
+        ADAPT.unmet[i] -= ADAPT.unmet[i] >> ADAPT_DECAY_SHIFT;
+    }
+
+    // 只在空闲期 (最近没有成功分配，分区表不在变化) 且不在冷却时间内调整
+    if (now < ADAPT.cooldown_until || now - ADAPT.last_alloc_time < ADAPT_QUIET_TICKS) return;
+
+    uint32_t total = hist_total(ADAPT.demand);
+    uint32_t unmet_total = hist_total(ADAPT.unmet);
+    if (total < ADAPT_MIN_WEIGHT) return;
+
+    int merge_at = unmet_total >= ADAPT_MIN_WEIGHT ? find_merge(hist_quantile(ADAPT.unmet, unmet_total, 50)) : -1;
+    int split_at = -1;
+    if (merge_at < 0 && unmet_total < ADAPT_WEIGHT) {
+        uint32_t typical = hist_quantile(ADAPT.demand, total, 50);
+        if (typical < MIN_PARTITION_SIZE) typical = MIN_PARTITION_SIZE;
+        split_at = find_split(typical, hist_quantile(ADAPT.demand, total, 95));
+        if (split_at >= 0 && ++ADAPT.split_votes >= ADAPT_STABLE_CHECKS) {
+            uint32_t keep = partition_table[split_at].size - typical;
+            kernel_log(LOG_INFO, "Adaptive split: partition 0x%x %d -> %d + %d",
+                partition_table[split_at].start, partition_table[split_at].size, keep, typical);
+            partition_split((uint32_t)split_at, keep);
+            ADAPT.stats.splits++;
+            ADAPT.split_votes = 0;
+            ADAPT.cooldown_until = now + ADAPT_COOLDOWN;
+        }
+    }
+    if (merge_at >= 0 && ++ADAPT.merge_votes >= ADAPT_STABLE_CHECKS) {
+        kernel_log(LOG_INFO, "Adaptive merge: partitions 0x%x + 0x%x -> %d bytes",
+            partition_table[merge_at].start, partition_table[merge_at + 1].start,
+            partition_table[merge_at].size + partition_table[merge_at + 1].size);
+        partition_merge((uint32_t)merge_at);
+        ADAPT.stats.merges++;
+        ADAPT.merge_votes = 0;
+        memset(ADAPT.unmet, 0, sizeof(ADAPT.unmet));
+        ADAPT.cooldown_until = now + ADAPT_COOLDOWN;
+    }
+
+    if (merge_at < 0) ADAPT.merge_votes = 0;
+    if (split_at < 0) ADAPT.split_votes = 0;
+}
+
+void adapt_get_stats(adapt_stats_t* out) {
+    *out = ADAPT.stats;
+}
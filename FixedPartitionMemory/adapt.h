@@ -0,0 +1,38 @@
+#ifndef _ADAPT_H
+#define _ADAPT_H
+
+#include "os_types.h"
+#include "config.h"
+
+// 自适应分区：统计最近的请求大小分布，在空闲期拆分或合并空闲分区 (已分配分区不动)
+// 拆分要求没有未满足的大请求，合并要求有未满足的大请求，并且同一调整需连续多次检查成立、
+// 调整后有冷却时间，避免来回抖动
+
+typedef struct adapt_stats_t {
+    uint32_t checks;    // 检查次数
+    uint32_t splits;    // 拆分次数
+    uint32_t merges;    // 合并次数
+} adapt_stats_t;
+
+#define ADAPT_BUCKETS ((MEMORY_SIZE - OS_PARTITION_SIZE) / ADAPT_GRANULARITY + 1)
+
+// 自适应状态 (每个内核上下文一份)
+typedef struct adapt_state_t {
+    int enabled;
+    uint32_t demand[ADAPT_BUCKETS];  // 请求大小直方图 (按粒度向上取整)
+    uint32_t unmet[ADAPT_BUCKETS];   // 总空闲足够但没有空闲分区能容纳的请求
+    uint32_t last_alloc_time;
+    uint32_t cooldown_until;
+    uint32_t split_votes;
+    uint32_t merge_votes;
+    adapt_stats_t stats;
+} adapt_state_t;
+
+void adapt_set_enabled(int enable);
+int adapt_is_enabled(void);
+void adapt_reset(void);
+void adapt_record_request(uint32_t size, int satisfied);   // 每次分配请求后调用
+void adapt_tick(uint32_t now);                              // 每个时间单位结束时调用
+void adapt_get_stats(adapt_stats_t* stats);
+
+#endif // _ADAPT_H
@@ -0,0 +1,200 @@
+// 固定大小对象反复分配/释放的基准 (ns/op)：fp_alloc.c 与系统 malloc/free 对比
+// 活跃对象槽位固定，每次操作随机选一个槽位，已占用则释放，否则分配一个对象并写入首尾字节；
+// 预热后约一半槽位占用。fp_alloc 池的大小类由分区布局换算 (默认为 partition.c 的预定义布局)，
+// 每个分区复制 scale 块，scale 默认使任一对象大小都有足够的块；
+// fp_parts / fp_pow2 是 fp_layout.h 的编译期布局 FP_LAYOUT_PARTITIONS / FP_LAYOUT_POW2，查表确定大小类
+// 编译: gcc -O2 -o bench_fp bench_fp.c fp_alloc.c
+// 运行: ./bench_fp [--size N]... [--live N] [--layout FILE] [--scale N] [--json]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fp_alloc.h"
+#include "fp_layout.h"
+#include "bench_util.h"
+
+#define SAMPLES 25
+#define SAMPLE_OPS 200000
+#define MAX_SIZES 16
+#define MAX_LAYOUT 1024
+
+typedef struct bench_alloc_t {
+    const char* name;
+    void* (*alloc)(size_t size);
+    void (*release)(void* ptr);
+} bench_alloc_t;
+
+FP_DEFINE_LAYOUT(parts, FP_LAYOUT_PARTITIONS)
+FP_DEFINE_LAYOUT(pow2, FP_LAYOUT_POW2)
+
+static fp_pool_t* pool;
+static fp_pool_t* parts_pool;
+static fp_pool_t* pow2_pool;
+static void** slots;
+static uint32_t live = 4096;
+static uint32_t rng_state = 2463534242u;
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void* pool_alloc(size_t size) { return fp_alloc(pool, size); }
+static void pool_release(void* ptr) { fp_free(pool, ptr); }
+static void* parts_pool_alloc(size_t size) { return parts_alloc(parts_pool, size); }
+static void parts_pool_release(void* ptr) { fp_free(parts_pool, ptr); }
+static void* pow2_pool_alloc(size_t size) { return pow2_alloc(pow2_pool, size); }
+static void pow2_pool_release(void* ptr) { fp_free(pow2_pool, ptr); }
+
+static const bench_alloc_t allocators[] = {
+    { "fp_alloc", pool_alloc, pool_release },
+    { "fp_parts", parts_pool_alloc, parts_pool_release },
+    { "fp_pow2", pow2_pool_alloc, pow2_pool_release },
+    { "malloc", malloc, free },
+};
+#define ALLOCATOR_COUNT (sizeof(allocators) / sizeof(allocators[0]))
+
+// 执行ops次操作，返回分配失败次数
+static uint64_t churn(const bench_alloc_t* a, size_t size, uint32_t ops) {
+    uint64_t failures = 0;
+    for (uint32_t n = 0; n < ops; n++) {
+        void** slot = &slots[rng_next() % live];
+        if (*slot) {
+            a->release(*slot);
+            *slot = NULL;
+        } else if ((*slot = a->alloc(size)) != NULL) {
+            ((volatile uint8_t*)*slot)[0] = (uint8_t)n;
+            ((volatile uint8_t*)*slot)[size - 1] = (uint8_t)n;
+        } else {
+            failures++;
+        }
+    }
+    return failures;
+}
+
+static void release_all(const bench_alloc_t* a) {
+    for (uint32_t i = 0; i < live; i++) {
+        if (slots[i]) a->release(slots[i]);
+        slots[i] = NULL;
+    }
+}
+
+// 布局文件: 分区大小以空白或逗号分隔，'#'开头到行尾为注释 (与 partition_load_layout 相同)
+static uint32_t load_layout(const char* path, uint32_t* sizes) {
+    uint32_t count = 0;
+    char line[256];
+    FILE* f = fopen(path, "r");
+
+    if (!f) return 0;
+    while (fgets(line, sizeof(line), f)) {
+        char* p = line;
+        while (*p && *p != '#') {
+            if (*p >= '0' && *p <= '9') {
+                uint32_t v = (uint32_t)strtoul(p, &p, 10);
+                if (v && count < MAX_LAYOUT) sizes[count++] = v;
+            } else {
+                p++;
+            }
+        }
+    }
+    fclose(f);
+    return count;
+}
+
+int main(int argc, char** argv) {
+    static const uint32_t default_layout[] = { 128, 128, 128, 128, 96, 96, 96, 96 };
+    uint32_t layout[MAX_LAYOUT];
+    uint32_t layout_count = sizeof(default_layout) / sizeof(default_layout[0]);
+    uint32_t sizes[MAX_SIZES];
+    uint32_t size_count = 0;
+    uint32_t scale = 0;
+    int json = 0;
+    int first = 1;
+
+    memcpy(layout, default_layout, sizeof(default_layout));
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) json = 1;
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc && size_count < MAX_SIZES) sizes[size_count++] = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--live") == 0 && i + 1 < argc) live = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) scale = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--layout") == 0 && i + 1 < argc) {
+            if (!(layout_count = load_layout(argv[++i], layout))) {
+                fprintf(stderr, "cannot load layout %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else { fprintf(stderr, "unknown option %s\n", argv[i]); return 1; }
+    }
+    if (live < 1) live = 1;
+    if (!size_count) {
+        sizes[size_count++] = 32;
+        sizes[size_count++] = 64;
+        sizes[size_count++] = 96;
+        sizes[size_count++] = 128;
+    }
+    // 默认每个分区复制live块: 只有一个分区能放下对象时也不会分配失败
+    if (!scale) scale = live;
+
+    fp_class_t classes[FP_MAX_CLASSES];
+    uint32_t class_count = fp_classes_from_layout(layout, layout_count, scale, classes, FP_MAX_CLASSES);
+    size_t region = fp_region_size(classes, class_count);
+    if (!class_count || !region || !(pool = fp_create(NULL, 0, classes, class_count))) {
+        fprintf(stderr, "cannot create pool (%u partitions, scale %u)\n", layout_count, scale);
+        return 1;
+    }
+    // 编译期布局: 预定义分区布局每类4块乘scale，2的幂每类live块
+    if (!(parts_pool = parts_create(NULL, 0, scale)) || !(pow2_pool = pow2_create(NULL, 0, live))) {
+        fprintf(stderr, "cannot create compile-time layout pools\n");
+        return 1;
+    }
+    slots = (void**)calloc(live, sizeof(void*));
+    if (!slots) return 1;
+
+    if (json) {
+        printf("{\"benchmark\":\"fp_alloc\",\"live\":%u,\"classes\":%u,\"region_bytes\":%llu,\"results\":[\n",
+            live, class_count, (unsigned long long)region);
+    } else {
+        printf("%u live slots, %u size classes from %u partitions x %u, region %llu bytes\n",
+            live, class_count, layout_count, scale, (unsigned long long)region);
+        printf("%-6s %-10s %10s %10s %10s %10s %8s\n", "size", "allocator", "min", "p50", "p90", "p99", "fail%");
+    }
+
+    for (uint32_t s = 0; s < size_count; s++) {
+        if (sizes[s] == 0) continue;
+        for (uint32_t a = 0; a < ALLOCATOR_COUNT; a++) {
+            const bench_alloc_t* alloc = &allocators[a];
+            double samples[SAMPLES];
+            uint64_t failures = 0;
+
+            // 预热: 槽位占用达到稳态
+            rng_state = 2463534242u;
+            churn(alloc, sizes[s], live * 8);
+            for (uint32_t k = 0; k < SAMPLES; k++) {
+                uint64_t t0 = bench_now_ns();
+                failures += churn(alloc, sizes[s], SAMPLE_OPS);
+                samples[k] = (double)(bench_now_ns() - t0) / SAMPLE_OPS;
+            }
+            release_all(alloc);
+
+            bench_stats_t st = bench_compute_stats(samples, SAMPLES);
+            double fail_pct = 100.0 * failures / ((double)SAMPLES * SAMPLE_OPS);
+            if (json) {
+                printf("%s{\"size\":%u,\"allocator\":\"%s\",\"ns_per_op\":{\"min\":%.2f,\"mean\":%.2f,\"p50\":%.2f,"
+                    "\"p90\":%.2f,\"p99\":%.2f,\"max\":%.2f},\"fail_pct\":%.3f}",
+                    first ? "" : ",\n", sizes[s], alloc->name, st.min, st.mean, st.p50, st.p90, st.p99, st.max, fail_pct);
+                first = 0;
+            } else {
+                printf("%-6u %-10s %10.2f %10.2f %10.2f %10.2f %8.2f\n",
+                    sizes[s], alloc->name, st.min, st.p50, st.p90, st.p99, fail_pct);
+            }
+        }
+    }
+
+    if (json) printf("\n]}\n");
+    free(slots);
+    fp_destroy(pool);
+    fp_destroy(parts_pool);
+    fp_destroy(pow2_pool);
+    return 0;
+}
@@ -0,0 +1,283 @@
+// 分配器与调度器热路径基准 (ns/op)
+// 表大小在编译期确定，用 bench_kernel.sh 在 16 到 1M 之间逐个编译运行：
+//   gcc -O2 -DMAX_PARTITIONS=4096 -DMAX_PROCESSES=4096 -o bench_kernel bench_kernel.c
+//       init.c log.c kstring.c perf.c frag.c adapt.c physmem.c traffic.c io.c swap.c process.c partition.c memory.c scheduler.c compact.c snapshot.c
+//   ./bench_kernel [--json] [--filter name]
+// find_free_partition_aos 是改为结构数组查找前的实现 (逐个读取partition_t)，用于对比；
+// 加 -DPARTITION_SEARCH_SIMD=0 编译可得到结构数组上的标量扫描；
+// scheduler_tick_* 是按 g_scheduler.type 分支的调度循环，*_static 是 scheduler_tick_for() 的编译期特化版本
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "os_types.h"
+#include "config.h"
+#include "log.h"
+#include "process.h"
+#include "partition.h"
+#include "memory.h"
+#include "scheduler.h"
+#include "kernel.h"
+#include "bench_util.h"
+
+#define SAMPLES 25
+#define WARMUP_NS 20000000ull      // 预热20ms
+#define SAMPLE_TARGET_NS 2000000ull // 每个样本约2ms
+
+typedef void (*bench_fn_t)(uint32_t iters);
+
+typedef struct bench_case_t {
+    const char* name;
+    uint32_t table_size;
+    void (*setup)(void);
+    bench_fn_t run;
+} bench_case_t;
+
+static uint32_t rng_state = 2463534242u;
+static uint32_t* lookup_pids;
+#define LOOKUP_COUNT 4096
+
+static uint32_t rng_next(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// 原实现: 在partition_t数组上顺序查找最佳匹配
+static partition_t* find_free_partition_aos(uint32_t size) {
+    partition_t* best_fit = NULL;
+    uint32_t best_fit_diff = 0xFFFFFFFF;
+
+    for (uint32_t i = 1; i < partition_count; i++) {
+        if (partition_table[i].state == PARTITION_FREE && partition_table[i].size >= size) {
+            uint32_t diff = partition_table[i].size - size;
+            if (diff < best_fit_diff) {
+                best_fit_diff = diff;
+                best_fit = &partition_table[i];
+            }
+        }
+    }
+    return best_fit;
+}
+
+// 直接构造含 MAX_PARTITIONS 个用户分区的分区表，约一半已分配
+static void setup_partitions(void) {
+    static const uint32_t sizes[] = { 128, 128, 96, 96, 64, 256 };
+    uint32_t addr = OS_PARTITION_SIZE;
+
+    partition_init();
+    partition_count = 1;
+    for (uint32_t i = 1; i < MAX_PARTITIONS; i++) {
+        partition_t* part = &partition_table[i];
+        part->start = addr;
+        part->size = sizes[rng_next() % 6];
+        part->state = (rng_next() & 1) ? PARTITION_ALLOCATED : PARTITION_FREE;
+        part->owner_pid = part->state == PARTITION_ALLOCATED ? i : 0;
+        addr += part->size;
+        partition_count++;
+    }
+    // 保证至少有一个能放下测试请求的空闲分区
+    partition_table[partition_count - 1].size = 256;
+    partition_table[partition_count - 1].state = PARTITION_FREE;
+    partition_table[partition_count - 1].owner_pid = 0;
+    partition_sync_index();
+
+    // 两种查找的结果必须一致
+    for (uint32_t size = 0; size <= 300; size++) {
+        if (find_free_partition(size) != find_free_partition_aos(size)) {
+            fprintf(stderr, "find_free_partition(%u) differs from the AoS scan\n", (unsigned)size);
+            exit(1);
+        }
+    }
+}
+
+// 填满进程表，只留最后一个空槽
+// (逐个create_process是O(n^2)，大表下直接填写槽位，最后一个进程仍走create_process)
+static void setup_processes(void) {
+    process_init();
+    for (uint32_t i = 0; i < MAX_PROCESSES - 1; i++) {
+        process_t* proc = &process_table[i];
+        proc->pid = i + 1;
+        sprintf(process_info(proc)->name, "p%u", i + 1);
+        proc->state = PROC_CREATED;
+        proc->memory_size = 64;
+        process_info(proc)->burst_time = 1000;
+        proc->remaining_time = 1000;
+        proc->priority = 3;
+    }
+    create_process(MAX_PROCESSES, "last", 64, 1000, 0);
+    terminate_process(&process_table[MAX_PROCESSES - 1]);
+
+    for (uint32_t i = 0; i < LOOKUP_COUNT; i++) {
+        lookup_pids[i] = rng_next() % (MAX_PROCESSES - 1) + 1;
+    }
+}
+
+// 所有进程就绪，剩余时间足够长不会结束
+static scheduler_tick_fn_t sched_tick;
+
+static void setup_scheduler_type(scheduler_type_t type) {
+    setup_processes();
+    scheduler_init(type);
+    sched_tick = scheduler_tick_for(type);
+    for (uint32_t i = 0; i < MAX_PROCESSES - 1; i++) {
+        process_table[i].remaining_time = 0xFFFFFFFFu;
+        scheduler_add_process(&process_table[i]);
+    }
+}
+
+static void setup_scheduler(void) { setup_scheduler_type(SCHED_RR); }
+static void setup_scheduler_fifo(void) { setup_scheduler_type(SCHED_FIFO); }
+static void setup_scheduler_priority(void) { setup_scheduler_type(SCHED_PRIORITY); }
+
+static void run_find_free_partition(uint32_t iters) {
+    uintptr_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += (uintptr_t)find_free_partition(100 + (i & 7));
+    }
+    bench_sink += acc;
+}
+
+static void run_find_free_partition_aos(uint32_t iters) {
+    uintptr_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += (uintptr_t)find_free_partition_aos(100 + (i & 7));
+    }
+    bench_sink += acc;
+}
+
+static void run_alloc_free(uint32_t iters) {
+    process_t* proc = &process_table[0];
+    proc->pid = 0x7FFFFFFF;  // 不与分区表中的owner_pid冲突
+    for (uint32_t i = 0; i < iters; i++) {
+        proc->state = PROC_READY;
+        proc->memory_size = 100 + (i & 7);
+        allocate_memory(proc, BEST_FIT);
+        free_memory(proc);
+    }
+}
+
+static void run_create_process(uint32_t iters) {
+    process_t* slot = &process_table[MAX_PROCESSES - 1];
+    for (uint32_t i = 0; i < iters; i++) {
+        process_t* proc = create_process(MAX_PROCESSES, "bench", 64, 10, 0);
+        bench_sink += (uintptr_t)proc;
+        terminate_process(slot);
+    }
+}
+
+static void run_find_process_by_pid(uint32_t iters) {
+    uintptr_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += (uintptr_t)find_process_by_pid(lookup_pids[i & (LOOKUP_COUNT - 1)]);
+    }
+    bench_sink += acc;
+}
+
+static void run_scheduler_tick(uint32_t iters) {
+    for (uint32_t i = 0; i < iters; i++) {
+        scheduler_schedule();
+        scheduler_run_current_process();
+    }
+}
+
+static void run_scheduler_tick_static(uint32_t iters) {
+    scheduler_tick_fn_t tick = sched_tick;
+    uintptr_t acc = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        acc += (uintptr_t)tick();
+    }
+    bench_sink += acc;
+}
+
+static const bench_case_t bench_cases[] = {
+    { "find_free_partition", MAX_PARTITIONS, setup_partitions, run_find_free_partition },
+    { "find_free_partition_aos", MAX_PARTITIONS, setup_partitions, run_find_free_partition_aos },
+    { "allocate_free_memory", MAX_PARTITIONS, setup_partitions, run_alloc_free },
+    { "create_process", MAX_PROCESSES, setup_processes, run_create_process },
+    { "find_process_by_pid", MAX_PROCESSES, setup_processes, run_find_process_by_pid },
+    { "scheduler_tick_rr", MAX_PROCESSES, setup_scheduler, run_scheduler_tick },
+    { "scheduler_tick_rr_static", MAX_PROCESSES, setup_scheduler, run_scheduler_tick_static },
+    { "scheduler_tick_fifo", MAX_PROCESSES, setup_scheduler_fifo, run_scheduler_tick },
+    { "scheduler_tick_fifo_static", MAX_PROCESSES, setup_scheduler_fifo, run_scheduler_tick_static },
+    { "scheduler_tick_prio", MAX_PROCESSES, setup_scheduler_priority, run_scheduler_tick },
+    { "scheduler_tick_prio_static", MAX_PROCESSES, setup_scheduler_priority, run_scheduler_tick_static },
+};
+#define BENCH_CASE_COUNT (sizeof(bench_cases) / sizeof(bench_cases[0]))
+
+// 预热并确定每个样本的迭代次数
+static uint32_t calibrate(bench_fn_t run) {
+    uint32_t iters = 1;
+    uint64_t start = bench_now_ns();
+    uint64_t elapsed = 0;
+
+    while (elapsed < WARMUP_NS) {
+        uint64_t t0 = bench_now_ns();
+        run(iters);
+        uint64_t t = bench_now_ns() - t0;
+        elapsed = bench_now_ns() - start;
+        if (t < SAMPLE_TARGET_NS / 4 && iters < (1u << 30)) iters *= 2;
+    }
+
+    uint64_t t0 = bench_now_ns();
+    run(iters);
+    uint64_t per_op = (bench_now_ns() - t0) / iters + 1;
+    uint64_t target = SAMPLE_TARGET_NS / per_op;
+    return target ? (uint32_t)target : 1;
+}
+
+int main(int argc, char** argv) {
+    int json = 0;
+    const char* filter = NULL;
+    int first = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) json = 1;
+        else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+    }
+
+    lookup_pids = (uint32_t*)malloc(LOOKUP_COUNT * sizeof(uint32_t));
+    if (!lookup_pids) return 1;
+    kernel_log_init();
+    memory_init();
+
+    if (json) {
+        printf("{\"benchmark\":\"kernel\",\"max_partitions\":%u,\"max_processes\":%u,\"results\":[\n",
+            (unsigned)MAX_PARTITIONS, (unsigned)MAX_PROCESSES);
+    } else {
+        printf("MAX_PARTITIONS=%u MAX_PROCESSES=%u\n", (unsigned)MAX_PARTITIONS, (unsigned)MAX_PROCESSES);
+        printf("%-26s %10s %10s %10s %10s %10s\n", "case", "min", "p50", "p90", "p99", "iters");
+    }
+
+    for (uint32_t c = 0; c < BENCH_CASE_COUNT; c++) {
+        const bench_case_t* bc = &bench_cases[c];
+        double samples[SAMPLES];
+
+        if (filter && !strstr(bc->name, filter)) continue;
+
+        bc->setup();
+        uint32_t iters = calibrate(bc->run);
+        for (int s = 0; s < SAMPLES; s++) {
+            uint64_t t0 = bench_now_ns();
+            bc->run(iters);
+            samples[s] = (double)(bench_now_ns() - t0) / iters;
+        }
+        bench_stats_t st = bench_compute_stats(samples, SAMPLES);
+
+        if (json) {
+            printf("%s{\"name\":\"%s\",\"table_size\":%u,\"samples\":%d,\"iters_per_sample\":%u,"
+                "\"ns_per_op\":{\"min\":%.2f,\"mean\":%.2f,\"p50\":%.2f,\"p90\":%.2f,\"p99\":%.2f,\"max\":%.2f}}",
+                first ? "" : ",\n", bc->name,
+                bc->table_size, SAMPLES, iters,
+                st.min, st.mean, st.p50, st.p90, st.p99, st.max);
+            first = 0;
+        } else {
+            printf("%-26s %10.1f %10.1f %10.1f %10.1f %10u\n",
+                bc->name, st.min, st.p50, st.p90, st.p99, iters);
+        }
+    }
+
+    if (json) printf("\n]}\n");
+    free(lookup_pids);
+    return 0;
+}
\ No newline at end of file
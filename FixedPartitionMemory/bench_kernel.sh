@@ -0,0 +1,21 @@
+#!/bin/bash
+# 在不同表大小下编译并运行 bench_kernel，输出合并后的JSON
+# 用法: ./bench_kernel.sh [输出文件]   (可用 SIZES="16 1024" 覆盖表大小)
+cd "$(dirname "$0")"
+OUT=${1:-bench_kernel.json}
+SIZES=${SIZES:-"16 64 256 1024 4096 16384 65536 262144 1048576"}
+KERNEL_SRCS="init.c log.c kstring.c perf.c frag.c adapt.c physmem.c traffic.c io.c swap.c process.c partition.c memory.c scheduler.c compact.c snapshot.c"
+BIN=$(mktemp)
+
+echo "[" > "$OUT"
+first=1
+for n in $SIZES; do
+    echo "table size $n" >&2
+    gcc -O2 -DMAX_PARTITIONS=$n -DMAX_PROCESSES=$n -o "$BIN" bench_kernel.c $KERNEL_SRCS || exit 1
+    [ $first -eq 1 ] || echo "," >> "$OUT"
+    "$BIN" --json >> "$OUT" || exit 1
+    first=0
+done
+echo "]" >> "$OUT"
+rm -f "$BIN"
+echo "results written to $OUT" >&2
\ No newline at end of file
@@ -0,0 +1,244 @@
+// 多线程分配压力基准：线程数从1倍增到N，比较三种线程安全的分配/释放
+//   locked:   一把全局锁保护 find_free_partition() + allocate_partition() / free_partition()
+//   lockfree: mtalloc.c 不带缓存，每次分配/释放是大小类无锁栈上的一次CAS
+//   cached:   mtalloc.c 的线程缓存，缓存空或满时才与无锁栈批量交换
+// 每个线程反复为自己的一组进程分配或释放分区 (已分配则释放，否则分配)，每线程操作数固定
+// 编译: gcc -O2 -DMAX_PARTITIONS=4096 -DMAX_PROCESSES=4096 -o bench_mt bench_mt.c mtalloc.c
+//       init.c log.c kstring.c perf.c frag.c adapt.c physmem.c traffic.c io.c swap.c process.c partition.c memory.c scheduler.c compact.c snapshot.c -lpthread
+// 运行: ./bench_mt [--threads N] [--ops N] [--json]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+// <sched.h> 的 SCHED_FIFO/SCHED_RR 宏与 scheduler.h 的枚举同名
+#undef SCHED_FIFO
+#undef SCHED_RR
+#include "kernel.h"
+#include "mtalloc.h"
+#include "bench_util.h"
+
+#define MAX_THREADS 256
+#define PROC_COUNT (MAX_PROCESSES - 1)
+
+typedef enum { MODE_LOCKED, MODE_LOCKFREE, MODE_CACHED, MODE_COUNT } bench_mode_t;
+static const char* const mode_names[MODE_COUNT] = { "locked", "lockfree", "cached" };
+
+typedef struct worker_t {
+    pthread_t thread;
+    uint32_t first;       // 本线程的进程在进程表中的范围 [first, first + count)
+    uint32_t count;
+    uint32_t rng;
+    mt_cache_t cache;
+    uint64_t ok;          // 成功的分配和释放次数
+    uint64_t failures;    // 分配失败次数
+} worker_t;
+
+static kernel_ctx_t* ctx;
+static bench_mode_t mode;
+static mt_pool_t* pool;
+static pthread_mutex_t big_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t ops_per_thread = 200000;
+static worker_t workers[MAX_THREADS];
+
+static uint32_t rng_next(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// 全部分区空闲、进程都未分配；分区大小在4类之间循环，进程请求16..512字节
+static void setup(void) {
+    static const uint32_t sizes[] = { 64, 128, 256, 512 };
+    uint32_t addr = OS_PARTITION_SIZE;
+    uint32_t rng = 2463534242u;
+
+    partition_init();
+    partition_count = 1;
+    for (uint32_t i = 1; i < MAX_PARTITIONS; i++) {
+        partition_t* part = &partition_table[i];
+        part->start = addr;
+        part->size = sizes[i % 4];
+        part->state = PARTITION_FREE;
+        part->owner_pid = 0;
+        part->used_size = 0;
+        addr += part->size;
+        partition_count++;
+    }
+    partition_sync_index();
+
+    process_init();
+    for (uint32_t i = 0; i < PROC_COUNT; i++) {
+        process_t* proc = &process_table[i];
+        proc->pid = i + 1;
+        proc->state = PROC_READY;
+        proc->memory_size = 16 + rng_next(&rng) % 497;
+        process_info(proc)->memory_start = 0;
+        process_info(proc)->memory_end = 0;
+    }
+}
+
+// 已分配分区与进程记录的地址范围一一对应
+static int verify(void) {
+    uint32_t allocated = 0, holding = 0;
+    for (uint32_t i = 1; i < partition_count; i++) {
+        const partition_t* part = &partition_table[i];
+        if (part->state != PARTITION_ALLOCATED) continue;
+        const process_t* proc = &process_table[part->owner_pid - 1];
+        if (process_info(proc)->memory_start != part->start || proc->memory_size > part->size ||
+            partition_index.state[i] != PARTITION_ALLOCATED) {
+            return -1;
+        }
+        allocated++;
+    }
+    for (uint32_t i = 0; i < PROC_COUNT; i++) {
+        holding += process_info(&process_table[i])->memory_start != 0;
+    }
+    return allocated == holding ? 0 : -1;
+}
+
+// 按起始地址二分查找进程的分区
+static partition_t* partition_of(const process_t* proc) {
+    uint32_t start = process_info(proc)->memory_start;
+    uint32_t lo = 1, hi = partition_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (partition_table[mid].start < start) lo = mid + 1;
+        else hi = mid;
+    }
+    return &partition_table[lo];
+}
+
+// 1, 2, 4, ... 最后一档为max_threads
+static uint32_t next_threads(uint32_t threads, uint32_t max_threads) {
+    if (threads == max_threads) return max_threads + 1;
+    return threads * 2 < max_threads ? threads * 2 : max_threads;
+}
+
+static void* worker_main(void* arg) {
+    worker_t* w = (worker_t*)arg;
+    kernel_ctx_bind(ctx);
+
+    for (uint64_t n = 0; n < ops_per_thread; n++) {
+        process_t* proc = &process_table[w->first + rng_next(&w->rng) % w->count];
+        int held = process_info(proc)->memory_start != 0;
+        int rc = 0;
+
+        if (mode != MODE_LOCKED) {
+            if (held) mt_free_memory(pool, &w->cache, proc);
+            else rc = mt_allocate_memory(pool, &w->cache, proc);
+        } else {
+            pthread_mutex_lock(&big_lock);
+            if (held) {
+                free_partition(partition_of(proc));
+                process_info(proc)->memory_start = 0;
+            } else {
+                rc = allocate_partition(find_free_partition(proc->memory_size), proc);
+            }
+            pthread_mutex_unlock(&big_lock);
+        }
+        if (rc == 0) w->ok++;
+        else w->failures++;
+    }
+    if (mode != MODE_LOCKED) mt_cache_flush(pool, &w->cache);
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    int json = 0;
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t max_threads = ncpu > 0 ? (uint32_t)ncpu : 1;
+    int first = 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) json = 1;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) max_threads = (uint32_t)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) ops_per_thread = (uint64_t)atoll(argv[++i]);
+        else { fprintf(stderr, "unknown option %s\n", argv[i]); return 1; }
+    }
+    if (max_threads < 1) max_threads = 1;
+    if (max_threads > MAX_THREADS) max_threads = MAX_THREADS;
+    if (max_threads > PROC_COUNT) max_threads = PROC_COUNT;
+
+    kernel_log_init();
+    memory_init();
+    ctx = kernel_ctx_current();
+
+    if (json) {
+        printf("{\"benchmark\":\"mt_alloc\",\"max_partitions\":%u,\"max_processes\":%u,\"ops_per_thread\":%llu,"
+            "\"results\":[\n", (unsigned)MAX_PARTITIONS, (unsigned)MAX_PROCESSES, (unsigned long long)ops_per_thread);
+    } else {
+        printf("MAX_PARTITIONS=%u MAX_PROCESSES=%u, %llu ops per thread, cache %u per class, batch %u\n",
+            (unsigned)MAX_PARTITIONS, (unsigned)MAX_PROCESSES, (unsigned long long)ops_per_thread,
+            MT_CACHE_SIZE, MT_BATCH);
+        printf("%-8s %7s %10s %8s %8s %11s %11s\n", "mode", "threads", "Mops/s", "speedup", "fail%", "shared/kop",
+            "retries/kop");
+    }
+
+    for (uint32_t m = 0; m < MODE_COUNT; m++) {
+        double base = 0;
+        mode = (bench_mode_t)m;
+        for (uint32_t threads = 1; threads <= max_threads; threads = next_threads(threads, max_threads)) {
+            setup();
+            if (mode != MODE_LOCKED && !(pool = mt_pool_create())) return 1;
+
+            // 进程平均分给各线程
+            uint32_t per = PROC_COUNT / threads;
+            uint32_t started = 0;
+            uint64_t t0 = bench_now_ns();
+            for (uint32_t t = 0; t < threads; t++) {
+                worker_t* w = &workers[t];
+                memset(w, 0, sizeof(*w));
+                w->first = t * per;
+                w->count = per;
+                w->rng = 0x9E3779B9u * (t + 1);
+                mt_cache_init(&w->cache, mode == MODE_CACHED ? MT_CACHE_SIZE : 0);
+                if (pthread_create(&w->thread, NULL, worker_main, w) != 0) break;
+                started++;
+            }
+            for (uint32_t t = 0; t < started; t++) {
+                pthread_join(workers[t].thread, NULL);
+            }
+            double secs = (double)(bench_now_ns() - t0) / 1e9;
+
+            // 访问共享结构 (全局锁或无锁栈) 的次数，以及无锁栈上的CAS冲突次数
+            uint64_t ok = 0, failures = 0, shared = 0, retries = 0;
+            for (uint32_t t = 0; t < started; t++) {
+                ok += workers[t].ok;
+                failures += workers[t].failures;
+                shared += mode == MODE_CACHED ? workers[t].cache.refills + workers[t].cache.flushes : ops_per_thread;
+                retries += workers[t].cache.retries;
+            }
+            if (started != threads || verify() != 0) {
+                fprintf(stderr, "%s with %u threads: partition table inconsistent\n", mode_names[m], threads);
+                return 1;
+            }
+            mt_pool_destroy(pool);
+            pool = NULL;
+
+            uint64_t total = ok + failures;
+            double mops = secs > 0 ? total / secs / 1e6 : 0;
+            if (threads == 1) base = mops;
+            double speedup = base > 0 ? mops / base : 0;
+            double fail_pct = total ? 100.0 * failures / total : 0;
+            double shared_per_kop = total ? 1000.0 * shared / total : 0;
+            double retries_per_kop = total ? 1000.0 * retries / total : 0;
+
+            if (json) {
+                printf("%s{\"mode\":\"%s\",\"threads\":%u,\"ops\":%llu,\"seconds\":%.4f,\"mops\":%.3f,"
+                    "\"speedup\":%.3f,\"fail_pct\":%.3f,\"shared_per_kop\":%.3f,\"retries_per_kop\":%.3f}",
+                    first ? "" : ",\n", mode_names[m], threads, (unsigned long long)total, secs, mops,
+                    speedup, fail_pct, shared_per_kop, retries_per_kop);
+                first = 0;
+            } else {
+                printf("%-8s %7u %10.2f %8.2f %8.2f %11.2f %11.2f\n",
+                    mode_names[m], threads, mops, speedup, fail_pct, shared_per_kop, retries_per_kop);
+            }
+        }
+    }
+
+    if (json) printf("\n]}\n");
+    return 0;
+}
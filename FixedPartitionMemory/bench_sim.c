@@ -0,0 +1,356 @@
+// 端到端模拟吞吐量基准：完整轨迹 (到达 -> 分配 -> 调度 -> 完成)
+// 在一次运行中比较所有分配策略与调度算法的组合
+// 编译: gcc -O2 -o bench_sim bench_sim.c sim.c init.c log.c kstring.c perf.c frag.c adapt.c physmem.c traffic.c io.c swap.c process.c partition.c memory.c scheduler.c compact.c snapshot.c
+// 运行: ./bench_sim [--count N] [--seed S] [--interarrival K] [--phase N] [--alt-memory MIN:MAX]
+//                   [--trace FILE] [--save-trace FILE] [--adaptive] [--mem-file FILE] [--huge-pages] [--populate]
+//                   [--traffic seq|stride|random] [--traffic-accesses N] [--traffic-stride S]
+//                   [--io N] [--io-service T] [--io-sched fifo|sstf|scan|clook|deadline] [--swap] [--swap-file FILE]
+//                   [--reclaim priority|remaining|waste|youngest] [--rt PCT] [--rt-slack K]
+//                   [--max-ticks T] [--repeat R] [--json] [--series FILE] [--procs FILE] [--frag FILE] [--perf]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "bench_util.h"
+#include "perf.h"
+#include "frag.h"
+#include "physmem.h"
+
+static const allocation_strategy_t strategies[] = { FIRST_FIT, BEST_FIT, WORST_FIT };
+static const scheduler_type_t schedulers[] = { SCHED_FIFO, SCHED_RR, SCHED_PRIORITY, SCHED_EDF };
+#define STRATEGY_COUNT (sizeof(strategies) / sizeof(strategies[0]))
+#define SCHEDULER_COUNT (sizeof(schedulers) / sizeof(schedulers[0]))
+
+int main(int argc, char** argv) {
+    trace_params_t params;
+    trace_t trace;
+    sim_config_t config;
+    const char* trace_path = NULL;
+    const char* save_path = NULL;
+    const char* series_path = NULL;
+    const char* procs_path = NULL;
+    const char* frag_path = NULL;
+    const char* mem_path = NULL;
+    uint32_t mem_flags = 0;
+    FILE* series = NULL;
+    FILE* procs = NULL;
+    FILE* frag = NULL;
+    frag_sample_t* frag_series = NULL;
+    uint32_t repeat = 3;
+    uint64_t io_total = 0;
+    uint32_t rt_total = 0;
+    int json = 0;
+    int perf = 0;
+    int first = 1;
+
+    trace_default_params(&params);
+    config.max_ticks = 0;
+    config.sample_interval = 10;
+    config.adaptive = 0;
+    config.traffic = TRAFFIC_NONE;
+    config.traffic_accesses = 0;
+    config.traffic_stride = 0;
+    config.io_service_time = 0;
+    config.io_sched = IO_SCHED_FIFO;
+    config.swap = 0;
+    config.reclaim = RECLAIM_PRIORITY;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--json") == 0) { json = 1; continue; }
+        if (strcmp(a, "--perf") == 0) { perf = 1; continue; }
+        if (strcmp(a, "--adaptive") == 0) { config.adaptive = 1; continue; }
+        if (strcmp(a, "--swap") == 0) { config.swap = 1; continue; }
+        if (strcmp(a, "--huge-pages") == 0) { mem_flags |= PHYSMEM_HUGE_PAGES; continue; }
+        if (strcmp(a, "--populate") == 0) { mem_flags |= PHYSMEM_POPULATE; continue; }
+        if (!v) { fprintf(stderr, "missing value for %s\n", a); return 1; }
+        if (strcmp(a, "--count") == 0) params.count = (uint32_t)atoi(v);
+        else if (strcmp(a, "--seed") == 0) params.seed = (uint32_t)atoi(v);
+        else if (strcmp(a, "--interarrival") == 0) params.max_interarrival = (uint32_t)atoi(v);
+        else if (strcmp(a, "--phase") == 0) params.phase_length = (uint32_t)atoi(v);
+        else if (strcmp(a, "--alt-memory") == 0) {
+            if (sscanf(v, "%u:%u", &params.alt_min_memory, &params.alt_max_memory) != 2) {
+                fprintf(stderr, "--alt-memory expects MIN:MAX\n");
+                return 1;
+            }
+        }
+        else if (strcmp(a, "--trace") == 0) trace_path = v;
+        else if (strcmp(a, "--save-trace") == 0) save_path = v;
+        else if (strcmp(a, "--max-ticks") == 0) config.max_ticks = (uint32_t)atoi(v);
+        else if (strcmp(a, "--repeat") == 0) repeat = (uint32_t)atoi(v);
+        else if (strcmp(a, "--series") == 0) series_path = v;
+        else if (strcmp(a, "--procs") == 0) procs_path = v;
+        else if (strcmp(a, "--frag") == 0) frag_path = v;
+        else if (strcmp(a, "--mem-file") == 0) mem_path = v;
+        else if (strcmp(a, "--swap-file") == 0) { swap_set_backing(v); config.swap = 1; }
+        else if (strcmp(a, "--traffic") == 0) {
+            if (strcmp(v, "seq") == 0) config.traffic = TRAFFIC_SEQUENTIAL;
+            else if (strcmp(v, "stride") == 0) config.traffic = TRAFFIC_STRIDED;
+            else if (strcmp(v, "random") == 0) config.traffic = TRAFFIC_RANDOM;
+            else { fprintf(stderr, "--traffic expects seq, stride or random\n"); return 1; }
+        }
+        else if (strcmp(a, "--traffic-accesses") == 0) config.traffic_accesses = (uint32_t)atoi(v);
+        else if (strcmp(a, "--traffic-stride") == 0) config.traffic_stride = (uint32_t)atoi(v);
+        else if (strcmp(a, "--io") == 0) params.max_io_requests = (uint32_t)atoi(v);
+        else if (strcmp(a, "--rt") == 0) params.rt_percent = (uint32_t)atoi(v);
+        else if (strcmp(a, "--rt-slack") == 0) params.rt_max_slack = (uint32_t)atoi(v);
+        else if (strcmp(a, "--io-service") == 0) config.io_service_time = (uint32_t)atoi(v);
+        else if (strcmp(a, "--io-sched") == 0) {
+            uint32_t s = 0;
+            while (s < IO_SCHED_COUNT && strcmp(v, io_sched_name((io_sched_t)s)) != 0) s++;
+            if (s == IO_SCHED_COUNT) {
+                fprintf(stderr, "--io-sched expects fifo, sstf, scan, clook or deadline\n");
+                return 1;
+            }
+            config.io_sched = (io_sched_t)s;
+        }
+        else if (strcmp(a, "--reclaim") == 0) {
+            uint32_t r = 0;
+            while (r < RECLAIM_COUNT && strcmp(v, reclaim_policy_name((reclaim_policy_t)r)) != 0) r++;
+            if (r == RECLAIM_COUNT) {
+                fprintf(stderr, "--reclaim expects priority, remaining, waste or youngest\n");
+                return 1;
+            }
+            config.reclaim = (reclaim_policy_t)r;
+        }
+        else { fprintf(stderr, "unknown option %s\n", a); return 1; }
+        i++;
+    }
+    if (repeat == 0) repeat = 1;
+    if (perf && !KERNEL_PERF) {
+        fprintf(stderr, "warning: --perf needs a build with -DKERNEL_PERF=1, counters will be empty\n");
+    }
+
+    if (physmem_set_backing(mem_path, mem_flags) != 0) {
+        return 1;
+    }
+
+    if (trace_path ? trace_load(&trace, trace_path) : trace_generate(&trace, &params)) {
+        fprintf(stderr, "failed to %s trace\n", trace_path ? "load" : "generate");
+        return 1;
+    }
+    if (save_path && trace_save(&trace, save_path) != 0) {
+        fprintf(stderr, "failed to save trace to %s\n", save_path);
+    }
+    for (uint32_t i = 0; i < trace.count; i++) io_total += trace.entries[i].io_requests;
+    for (uint32_t i = 0; i < trace.count; i++) rt_total += trace.entries[i].deadline != 0;
+    if (config.max_ticks == 0) {
+        // 默认上限: 最后到达时间加上全部执行时间和I/O服务时间 (按全程寻道估计)
+        uint64_t total = trace.count ? trace.entries[trace.count - 1].arrival_time : 0;
+        for (uint32_t i = 0; i < trace.count; i++) total += trace.entries[i].burst_time;
+        total += io_total * ((config.io_service_time ? config.io_service_time : IO_SERVICE_TIME) +
+            (DISK_TRACKS + DISK_SEEK_SPEED - 1) / DISK_SEEK_SPEED);
+        config.max_ticks = (uint32_t)(total + 1000 < 0xFFFFFFF0u ? total + 1000 : 0xFFFFFFF0u);
+    }
+
+    if (series_path && (series = fopen(series_path, "w")) != NULL) {
+        fprintf(series, "strategy,scheduler,time,allocated_bytes,requested_bytes,ready_count\n");
+    }
+    if (procs_path && (procs = fopen(procs_path, "w")) != NULL) {
+        fprintf(procs, "strategy,scheduler,index,status,arrival,admit,start,finish,turnaround,waiting,response,"
+            "deadline,lateness,memory_waits\n");
+    }
+    if (frag_path && (frag = fopen(frag_path, "w")) != NULL) {
+        frag_series = (frag_sample_t*)malloc(sizeof(frag_sample_t) * FRAG_SERIES_SIZE);
+        fprintf(frag, "strategy,scheduler,time,allocated_bytes,internal_waste,free_bytes,largest_free,"
+            "external_frag,failures_despite_free\n");
+    }
+
+    if (json) {
+        printf("{\"benchmark\":\"simulation\",\"processes\":%u,\"results\":[\n", trace.count);
+    } else {
+        printf("trace: %u processes, max %u ticks, best of %u runs%s%s\n", trace.count, config.max_ticks, repeat,
+            config.adaptive ? ", adaptive partitions" : "", config.swap ? ", swapping" : "");
+        if (config.swap) {
+            printf("swap reclaim policy: %s\n", reclaim_policy_name(config.reclaim));
+        }
+        if (config.traffic != TRAFFIC_NONE) {
+            printf("process memory traffic: %s\n", traffic_pattern_name(config.traffic));
+        }
+        if (io_total) {
+            printf("I/O: %llu requests, %u ticks each plus seek over %u tracks, %s scheduling\n",
+                (unsigned long long)io_total, config.io_service_time ? config.io_service_time : IO_SERVICE_TIME,
+                DISK_TRACKS, io_sched_name(config.io_sched));
+        }
+        if (rt_total) {
+            printf("real-time: %u processes with deadlines, EDF admission on utilization and free partitions\n",
+                rt_total);
+        }
+        printf("%-10s %-9s %6s %5s %5s %8s %10s %8s %8s %8s %6s %5s %6s %6s %6s %6s %8s %8s\n",
+            "strategy", "scheduler", "done", "rej", "unfin", "ticks", "events/s",
+            "turn", "wait", "resp", "p95", "cpu%", "mem%", "eff%", "ifrag%", "efrag%", "fails", "nofit");
+    }
+
+    for (uint32_t si = 0; si < STRATEGY_COUNT; si++) {
+        for (uint32_t ci = 0; ci < SCHEDULER_COUNT; ci++) {
+            sim_result_t result;
+            double best_ns = 0;
+
+            config.strategy = strategies[si];
+            config.scheduler = schedulers[ci];
+            perf_reset();
+
+            for (uint32_t r = 0; r < repeat; r++) {
+                uint64_t t0 = bench_now_ns();
+                if (sim_run(&trace, &config, &result) != 0) {
+                    fprintf(stderr, "simulation failed\n");
+                    return 1;
+                }
+                double ns = (double)(bench_now_ns() - t0);
+                if (r == 0 || ns < best_ns) best_ns = ns;
+                if (r + 1 < repeat) sim_result_free(&result);
+            }
+
+            const char* sname = sim_strategy_name(config.strategy);
+            const char* cname = sim_scheduler_name(config.scheduler);
+            double events_per_sec = best_ns > 0 ? result.events * 1e9 / best_ns : 0;
+            double cpu = result.ticks ? 100.0 * result.busy_ticks / result.ticks : 0;
+            double dev = result.ticks ? 100.0 * result.io.busy_ticks / result.ticks : 0;
+            double swap_util = result.ticks ? 100.0 * result.swap.busy_ticks / result.ticks : 0;
+            double throughput = result.ticks ? 1000.0 * result.completed / result.ticks : 0;
+            double io_wait = result.io.completed ? (double)result.io.blocked_ticks / result.io.completed : 0;
+            double io_seek = result.io.completed ? (double)result.io.seek_tracks / result.io.completed : 0;
+
+            if (json) {
+                printf("%s{\"strategy\":\"%s\",\"scheduler\":\"%s\",\"completed\":%u,\"rejected\":%u,"
+                    "\"unfinished\":%u,\"ticks\":%u,\"events\":%llu,\"wall_ms\":%.3f,\"events_per_sec\":%.0f,"
+                    "\"avg_turnaround\":%.3f,\"avg_waiting\":%.3f,\"avg_response\":%.3f,\"avg_admit_delay\":%.3f,\"p95_turnaround\":%u,"
+                    "\"cpu_util\":%.4f,\"mean_alloc_util\":%.4f,\"mean_req_util\":%.4f,\"peak_alloc_util\":%.4f,"
+                    "\"alloc_failures\":%llu,\"failures_despite_free\":%llu,\"avg_alloc_waste\":%.3f,"
+                    "\"mean_internal_frag\":%.4f,\"mean_external_frag\":%.4f,\"splits\":%u,\"merges\":%u",
+                    first ? "" : ",\n", sname, cname, result.completed, result.rejected,
+                    result.unfinished, result.ticks, (unsigned long long)result.events,
+                    best_ns / 1e6, events_per_sec, result.avg_turnaround, result.avg_waiting,
+                    result.avg_response, result.avg_admit_delay, result.p95_turnaround, cpu / 100, result.mean_alloc_util,
+                    result.mean_req_util, result.peak_alloc_util, (unsigned long long)result.alloc_failures,
+                    (unsigned long long)result.failures_despite_free, result.avg_alloc_waste,
+                    result.mean_internal_frag, result.mean_external_frag, result.splits, result.merges);
+                if (config.traffic != TRAFFIC_NONE) {
+                    printf(",\"traffic\":{\"pattern\":\"%s\",\"accesses\":%llu,\"verified_bytes\":%llu,"
+                        "\"corruptions\":%llu,\"violations\":%llu}", traffic_pattern_name(config.traffic),
+                        (unsigned long long)result.traffic.accesses, (unsigned long long)result.traffic.verified_bytes,
+                        (unsigned long long)result.traffic.corruptions, (unsigned long long)result.traffic.violations);
+                }
+                if (config.swap) {
+                    printf(",\"swap\":{\"policy\":\"%s\",\"reclaims\":%llu,\"swap_outs\":%llu,\"swap_ins\":%llu,"
+                        "\"bytes_out\":%llu,\"bytes_in\":%llu,\"channel_util\":%.4f,\"max_swapped\":%u,\"errors\":%llu}",
+                        reclaim_policy_name(config.reclaim), (unsigned long long)result.swap.reclaims,
+                        (unsigned long long)result.swap.swap_outs, (unsigned long long)result.swap.swap_ins,
+                        (unsigned long long)result.swap.bytes_out, (unsigned long long)result.swap.bytes_in,
+                        swap_util / 100, result.swap.max_swapped, (unsigned long long)result.swap.errors);
+                }
+                if (io_total) {
+                    printf(",\"io\":{\"scheduler\":\"%s\",\"requests\":%llu,\"completed\":%llu,\"device_util\":%.4f,"
+                        "\"avg_blocked\":%.3f,\"p95_blocked\":%u,\"max_blocked\":%u,\"avg_seek_tracks\":%.3f,"
+                        "\"max_queue\":%u,\"throughput_per_1k_ticks\":%.3f,\"avg_partition_hold\":%.3f}",
+                        io_sched_name(config.io_sched), (unsigned long long)result.io.requests,
+                        (unsigned long long)result.io.completed, dev / 100, io_wait,
+                        io_latency_percentile(&result.io, 0.95), result.io.max_latency, io_seek,
+                        result.io.max_queue, throughput, result.avg_hold);
+                }
+                if (rt_total) {
+                    printf(",\"rt\":{\"tasks\":%u,\"rejected\":%u,\"misses\":%u,\"miss_rate\":%.4f,"
+                        "\"mean_lateness\":%.3f,\"max_lateness\":%d,\"waited_for_memory\":%u,\"misses_after_memory_wait\":%u,"
+                        "\"avg_memory_wait\":%.3f,\"preemptions\":%llu}",
+                        result.rt_tasks, result.rt_rejected, result.rt_misses,
+                        result.rt_tasks ? (double)result.rt_misses / result.rt_tasks : 0, result.rt_mean_lateness,
+                        result.rt_max_lateness, result.rt_waited, result.rt_misses_waited, result.rt_avg_memory_wait,
+                        (unsigned long long)result.rt.preemptions);
+                }
+                if (perf) {
+                    printf(",\"perf\":[");
+                    for (uint32_t p = 0; p < PERF_COUNTER_COUNT; p++) {
+                        perf_stats_t st;
+                        perf_get_stats((perf_counter_t)p, &st);
+                        printf("%s{\"name\":\"%s\",\"calls\":%llu,\"mean_ns\":%.1f,\"p50_ns\":%.1f,"
+                            "\"p90_ns\":%.1f,\"p99_ns\":%.1f,\"max_ns\":%.1f}", p ? "," : "", st.name,
+                            (unsigned long long)st.calls, st.mean_ns, st.p50_ns, st.p90_ns, st.p99_ns, st.max_ns);
+                    }
+                    printf("]");
+                }
+                printf("}");
+                first = 0;
+            } else {
+                printf("%-10s %-9s %6u %5u %5u %8u %10.0f %8.1f %8.1f %8.1f %6u %5.1f %6.1f %6.1f %6.1f %6.1f %8llu %8llu\n",
+                    sname, cname, result.completed, result.rejected, result.unfinished, result.ticks,
+                    events_per_sec, result.avg_turnaround, result.avg_waiting, result.avg_response,
+                    result.p95_turnaround, cpu, result.mean_alloc_util * 100, result.mean_req_util * 100,
+                    result.mean_internal_frag * 100, result.mean_external_frag * 100,
+                    (unsigned long long)result.alloc_failures, (unsigned long long)result.failures_despite_free);
+                if (config.adaptive) {
+                    printf("    adaptive: %u splits, %u merges\n", result.splits, result.merges);
+                }
+                if (config.traffic != TRAFFIC_NONE) {
+                    printf("    traffic: %llu accesses, %llu bytes verified, %llu corrupted, %llu out of bounds\n",
+                        (unsigned long long)result.traffic.accesses, (unsigned long long)result.traffic.verified_bytes,
+                        (unsigned long long)result.traffic.corruptions, (unsigned long long)result.traffic.violations);
+                }
+                if (config.swap) {
+                    printf("    swap: %llu reclaims, %llu out (%llu bytes), %llu in (%llu bytes), channel %.1f%% busy, "
+                        "max %u swapped out\n", (unsigned long long)result.swap.reclaims,
+                        (unsigned long long)result.swap.swap_outs, (unsigned long long)result.swap.bytes_out,
+                        (unsigned long long)result.swap.swap_ins, (unsigned long long)result.swap.bytes_in,
+                        swap_util, result.swap.max_swapped);
+                }
+                if (io_total) {
+                    printf("    io: %llu requests, device %.1f%% busy, blocked avg %.1f p95 %u max %u ticks, "
+                        "%.1f tracks per seek, max queue %u, %.2f completions per 1000 ticks, "
+                        "partition held %.1f ticks\n",
+                        (unsigned long long)result.io.requests, dev, io_wait, io_latency_percentile(&result.io, 0.95),
+                        result.io.max_latency, io_seek, result.io.max_queue, throughput, result.avg_hold);
+                }
+                if (rt_total) {
+                    printf("    rt: %u/%u missed, %u rejected, lateness avg %.1f max %d, %u waited for a partition "
+                        "(avg %.1f ticks, %u of them missed), %llu preemptions\n",
+                        result.rt_misses, result.rt_tasks, result.rt_rejected, result.rt_mean_lateness,
+                        result.rt_max_lateness, result.rt_waited, result.rt_avg_memory_wait, result.rt_misses_waited,
+                        (unsigned long long)result.rt.preemptions);
+                }
+                for (uint32_t p = 0; perf && p < PERF_COUNTER_COUNT; p++) {
+                    perf_stats_t st;
+                    perf_get_stats((perf_counter_t)p, &st);
+                    printf("    %-20s %10llu calls  avg %8.1f  p50 %8.1f  p90 %8.1f  p99 %8.1f  max %10.1f ns\n",
+                        st.name, (unsigned long long)st.calls, st.mean_ns, st.p50_ns, st.p90_ns,
+                        st.p99_ns, st.max_ns);
+                }
+            }
+
+            if (series) {
+                for (uint32_t i = 0; i < result.sample_count; i++) {
+                    const sim_sample_t* s = &result.samples[i];
+                    fprintf(series, "%s,%s,%u,%u,%u,%u\n", sname, cname, s->time,
+                        s->allocated_bytes, s->requested_bytes, s->ready_count);
+                }
+            }
+            if (frag_series) {
+                uint32_t n = frag_get_series(frag_series, FRAG_SERIES_SIZE);
+                for (uint32_t i = 0; i < n; i++) {
+                    const frag_sample_t* s = &frag_series[i];
+                    fprintf(frag, "%s,%s,%u,%u,%u,%u,%u,%.4f,%u\n", sname, cname, s->time,
+                        s->allocated_bytes, s->internal_waste, s->free_bytes, s->largest_free,
+                        frag_external(s->free_bytes, s->largest_free), s->failures_despite_free);
+                }
+            }
+            if (procs) {
+                static const char* status_str[] = { "unfinished", "completed", "rejected" };
+                for (uint32_t i = 0; i < trace.count; i++) {
+                    const sim_proc_result_t* p = &result.procs[i];
+                    fprintf(procs, "%s,%s,%u,%s,%u,%u,%u,%u,%u,%u,%u,%u,%d,%u\n", sname, cname, i,
+                        status_str[p->status], trace.entries[i].arrival_time, p->admit_time,
+                        p->start_time, p->finish_time, p->turnaround, p->waiting, p->response,
+                        trace.entries[i].deadline, p->lateness, p->memory_waits);
+                }
+            }
+            sim_result_free(&result);
+        }
+    }
+
+    if (json) printf("\n]}\n");
+    if (series) fclose(series);
+    if (procs) fclose(procs);
+    if (frag) fclose(frag);
+    free(frag_series);
+    trace_free(&trace);
+    return 0;
+}
\ No newline at end of file
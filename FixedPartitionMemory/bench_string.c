@@ -0,0 +1,131 @@
+// memcpy/memset/strlen 各实现的微基准
+// 编译: gcc -O2 -o bench_string bench_string.c kstring.c
+// 运行: ./bench_string [--json]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "kstring.h"
+#include "bench_util.h"
+
+#define SAMPLES 15
+#define BYTES_PER_SAMPLE (16u << 20)   // 每个样本处理约16MB
+#define MAX_SIZE (1u << 20)
+
+static const uint32_t sizes[] = { 8, 32, 64, 256, 1024, 4096, 65536, 1u << 20 };
+#define SIZE_COUNT (sizeof(sizes) / sizeof(sizes[0]))
+
+static const char* op_names[] = { "memcpy", "memset", "strlen" };
+
+static uint8_t* src_buf;
+static uint8_t* dst_buf;
+
+// 与逐字节实现逐个比较，覆盖各种大小和对齐
+static int verify_ops(const kstring_ops_t* ref, const kstring_ops_t* ops) {
+    static uint8_t a[600], b[600];
+    for (uint32_t off = 0; off < 33; off++) {
+        for (uint32_t n = 0; n < 520; n += (n < 80 ? 1 : 37)) {
+            for (uint32_t i = 0; i < sizeof(a); i++) {
+                a[i] = (uint8_t)(i * 7 + 1);
+                b[i] = 0xEE;
+            }
+            ops->memcpy_fn(b + off, a + (off * 3) % 17, n);
+            for (uint32_t i = 0; i < sizeof(b); i++) {
+                uint8_t expect = (i >= off && i < off + n) ? a[(off * 3) % 17 + i - off] : 0xEE;
+                if (b[i] != expect) return -1;
+            }
+
+            ops->memset_fn(b + off, 0x5A, n);
+            for (uint32_t i = off; i < off + n; i++) {
+                if (b[i] != 0x5A) return -1;
+            }
+            if (off > 0 && b[off - 1] == 0x5A) return -1;
+            if (b[off + n] == 0x5A) return -1;
+
+            a[off + n] = 0;
+            if (ops->strlen_fn((const char*)a + off) != ref->strlen_fn((const char*)a + off)) return -1;
+        }
+    }
+    return 0;
+}
+
+// 返回每次调用的纳秒数
+static double run_sample(const kstring_ops_t* ops, int op, uint32_t size, uint32_t iters) {
+    uint64_t acc = 0;
+    uint64_t start = bench_now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        switch (op) {
+            case 0: ops->memcpy_fn(dst_buf, src_buf, size); break;
+            case 1: ops->memset_fn(dst_buf, (int)i, size); break;
+            default: acc += ops->strlen_fn((const char*)src_buf); break;
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_sink += acc + dst_buf[size - 1];
+    return (double)elapsed / iters;
+}
+
+int main(int argc, char** argv) {
+    int json = (argc > 1 && strcmp(argv[1], "--json") == 0);
+    const kstring_ops_t* ref = kstring_get_ops(KSTRING_IMPL_BYTE);
+    int first = 1;
+
+    // 多留64字节，保证SIMD读取不越界
+    src_buf = (uint8_t*)malloc(MAX_SIZE + 64);
+    dst_buf = (uint8_t*)malloc(MAX_SIZE + 64);
+    if (!src_buf || !dst_buf) return 1;
+    for (uint32_t i = 0; i < MAX_SIZE + 64; i++) {
+        src_buf[i] = (uint8_t)(i % 251 + 1);
+    }
+
+    for (int impl = 0; impl < KSTRING_IMPL_COUNT; impl++) {
+        const kstring_ops_t* ops = kstring_get_ops((kstring_impl_t)impl);
+        if (ops && verify_ops(ref, ops) != 0) {
+            fprintf(stderr, "%s implementation failed verification\n", ops->name);
+            return 1;
+        }
+    }
+
+    if (json) printf("{\"benchmark\":\"kstring\",\"results\":[\n");
+    else printf("%-7s %8s %-5s %12s %12s %10s\n", "op", "size", "impl", "ns/call p50", "ns/call p99", "GB/s");
+
+    for (int op = 0; op < 3; op++) {
+        for (uint32_t si = 0; si < SIZE_COUNT; si++) {
+            uint32_t size = sizes[si];
+            uint32_t iters = BYTES_PER_SAMPLE / size;
+
+            for (int impl = 0; impl < KSTRING_IMPL_COUNT; impl++) {
+                const kstring_ops_t* ops = kstring_get_ops((kstring_impl_t)impl);
+                double samples[SAMPLES];
+                if (!ops) continue;
+
+                // strlen 需要在 size 处结束
+                src_buf[size] = 0;
+                run_sample(ops, op, size, iters / 4 + 1);  // 预热
+                for (int s = 0; s < SAMPLES; s++) {
+                    samples[s] = run_sample(ops, op, size, iters);
+                }
+                src_buf[size] = (uint8_t)(size % 251 + 1);
+
+                bench_stats_t st = bench_compute_stats(samples, SAMPLES);
+                double gbps = size / st.p50;
+                if (json) {
+                    printf("%s{\"op\":\"%s\",\"size\":%u,\"impl\":\"%s\",\"ns_p50\":%.3f,"
+                        "\"ns_p99\":%.3f,\"ns_min\":%.3f,\"gb_per_s\":%.3f}",
+                        first ? "" : ",\n", op_names[op], size, ops->name,
+                        st.p50, st.p99, st.min, gbps);
+                    first = 0;
+                } else {
+                    printf("%-7s %8u %-5s %12.2f %12.2f %10.2f\n",
+                        op_names[op], size, ops->name, st.p50, st.p99, gbps);
+                }
+            }
+        }
+    }
+
+    if (json) printf("\n],\"active_impl\":\"%s\"}\n", kstring_get_ops(kstring_active_impl())->name);
+    else printf("active implementation: %s\n", kstring_get_ops(kstring_active_impl())->name);
+
+    free(src_buf);
+    free(dst_buf);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef _BENCH_UTIL_H
+#define _BENCH_UTIL_H
+
+// 基准测试公共工具 (计时、统计)，仅供 bench_*.c 使用
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+// 单调时钟，纳秒
+static inline uint64_t bench_now_ns(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (!freq.QuadPart) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)((double)now.QuadPart * 1e9 / (double)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+// 防止被测结果被编译器优化掉
+static volatile uint64_t bench_sink;
+
+// 样本统计
+typedef struct bench_stats_t {
+    double min;
+    double mean;
+    double p50;
+    double p90;
+    double p99;
+    double max;
+} bench_stats_t;
+
+static inline int bench_cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// 最近秩百分位，samples必须已排序
+static inline double bench_percentile(const double* samples, uint32_t n, double pct) {
+    uint32_t idx = (uint32_t)(pct / 100.0 * n + 0.999999);
+    if (idx == 0) idx = 1;
+    if (idx > n) idx = n;
+    return samples[idx - 1];
+}
+
+// 计算统计量 (会对samples原地排序)
+static inline bench_stats_t bench_compute_stats(double* samples, uint32_t n) {
+    bench_stats_t st = { 0, 0, 0, 0, 0, 0 };
+    double sum = 0;
+
+    if (n == 0) return st;
+    qsort(samples, n, sizeof(double), bench_cmp_double);
+    for (uint32_t i = 0; i < n; i++) {
+        sum += samples[i];
+    }
+    st.min = samples[0];
+    st.max = samples[n - 1];
+    st.mean = sum / n;
+    st.p50 = bench_percentile(samples, n, 50);
+    st.p90 = bench_percentile(samples, n, 90);
+    st.p99 = bench_percentile(samples, n, 99);
+    return st;
+}
+
+#endif // _BENCH_UTIL_H
\ No newline at end of file
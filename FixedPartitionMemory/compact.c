@@ -6,36 +6,17 @@
 #include "config.h"
 #include "kernel.h"
 
-// ⲿ
-extern process_t process_table[MAX_PROCESSES];
-extern uint32_t partition_count;
-extern partition_t partition_table[MAX_PARTITIONS];
 
-
-// ߼㷨 (ƶ)
+// ߼㷨: ˳ΪÿŲµĽ̡̻ڳֱûл޷ڳ
 void advanced_compact_memory(void) {
     kernel_log(LOG_INFO, "Performing advanced memory compaction");
 
-    // ڹ̶ϵͳУղо
-    // ǽֹụַ̂ṹ
-    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
-        if (process_table[i].state != PROC_TERMINATED && process_table[i].pid != 0) {
-            // ֹֻǲϵͳ
-            if (process_table[i].pid > 0) {
-                terminate_process(&process_table[i]);
-            }
-        }
-    }
-
-    // ͷз
-    for (uint32_t i = 1; i < partition_count; i++) {
-        if (partition_table[i].state == PARTITION_ALLOCATED) {
-            partition_table[i].state = PARTITION_FREE;
-            partition_table[i].owner_pid = 0;
-        }
+    uint32_t admitted = 0;
+    while (compact_memory() == 0) {
+        admitted++;
     }
 
-    kernel_log(LOG_INFO, "Memory compaction completed - all user processes terminated");
+    kernel_log(LOG_INFO, "Memory compaction completed - %d process(es) admitted, none terminated", admitted);
     dump_memory_map();
     dump_memory_statistics();
 }
\ No newline at end of file
@@ -4,7 +4,9 @@
 #include "os_types.h"
 
 // ϵͳ
-#define MEMORY_SIZE 1024        // 1KBڴ
+#ifndef MEMORY_SIZE
+#define MEMORY_SIZE 1024        // 1KBڴ ( -DMEMORY_SIZE=... Ϊģڴ棬4GB-1)
+#endif
 #define OS_PARTITION_SIZE 128   // ϵͳռ128ֽ
 #define MIN_PARTITION_SIZE 32   // СС
 #define DEFAULT_ALLOCATION_STRATEGY BEST_FIT
@@ -14,7 +16,57 @@
 #define TIMER_INTERVAL 1000     // 1
 
 // ־
-#define KERNEL_LOG_LEVEL LOG_INFO
+#ifndef KERNEL_LOG_LEVEL
+#define KERNEL_LOG_LEVEL LOG_INFO  // ڴ˼־ڱڱ
+#endif
 #define LOG_BUFFER_SIZE 1024
+#define LOG_RECORD_COUNT 32     // ʽ־¼
+#define LOG_MAX_ARGS 8          // ÿ¼
+#define LOG_RECORD_STR_SIZE 64  // ÿ¼%sĿռ
+
+// Ƭͳ
+#define FRAG_SERIES_SIZE 4096   // ƬʱౣĲ
+
+// Ӧ
+#define ADAPT_GRANULARITY ((MEMORY_SIZE - OS_PARTITION_SIZE) / 8192 > 8 ? \
+    (MEMORY_SIZE - OS_PARTITION_SIZE) / 8192 : 8)   // СֱͼͲִС (ֱͼԼ8KͰ)
+#define ADAPT_INTERVAL 8        // ÿʱ䵥λһ
+#define ADAPT_QUIET_TICKS 2     // ʱ䵥λûгɹΪ
+#define ADAPT_STABLE_CHECKS 2   // ͬһļ
+#define ADAPT_COOLDOWN 32       // ȴʱ
+#define ADAPT_DECAY_SHIFT 1     // ÿμֱͼ˥ 1/2^N
+
+// ôģ
+#define TRAFFIC_ACCESSES_PER_TICK 64   // еĽÿʱ䵥λķʴ
+#define TRAFFIC_STRIDE 64              // ʵֽڼ ()
+
+// I/Oģ
+#define IO_SERVICE_TIME 2       // ÿI/OѰռ豸ʱ䵥λ (ת + )
+#define IO_DEADLINE 40          // deadline: ȴʱȷ
+#define DISK_TRACKS 200         // ̴ŵ
+#define DISK_SEEK_SPEED 25      // ͷÿʱ䵥λƶĴŵ
+
+// 
+#define SWAP_LATENCY 2          // ÿλ/Ĺ̶ (ʱ䵥λ)
+#define SWAP_BYTES_PER_TICK 32  // ͨÿʱ䵥λֽ
+#define SWAP_MIN_RESIDENT 20    // ̻ڴפôòܱ
+
+// ̷߳ (mtalloc.c)
+#define MT_MAX_CLASSES 16       // С
+#define MT_CACHE_SIZE 16        // ÿ߳ÿ໺Ŀз
+#define MT_BATCH 8              // ̻߳빲֮ÿƶķ (MT_CACHE_SIZE)
+
+// 
+#ifndef PARTITION_SEARCH_SIMD
+#define PARTITION_SEARCH_SIMD 1 // find_free_partitionx86SSE2ÿαȽ40Ϊѭ
+#endif
+
+// 
+#define SNAPSHOT_FILE "kernel_snapshot.bin"   // ʾ S/L ʹõĿļ
+
+// ܼ
+#ifndef KERNEL_PERF
+#define KERNEL_PERF 0           // 1: ͳ·ĵôӳٷֲ
+#endif
 
 #endif // _CONFIG_H
\ No newline at end of file
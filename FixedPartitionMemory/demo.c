@@ -15,14 +15,13 @@
 #include "log.h"
 #include "config.h"
 #include "kernel.h"
+#include "snapshot.h"
 #include "scheduler.h"
 
 // ȫֱ
 static BOOL use_timer = FALSE;
 static BOOL running = TRUE;
 static uint32_t simulated_time = 0;
-extern allocation_strategy_t current_strategy;
-extern scheduler_t g_scheduler;
 
 FILE* log_file = NULL;
 
@@ -208,7 +207,6 @@ void display_system_status() {
     log_printf("\n--- ״̬ ---\n");
     log_printf("PID             ״̬      ڴС  ʣʱ  ʱ\n");
 
-    extern process_t process_table[MAX_PROCESSES];
     for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
         process_t* proc = &process_table[i];
         if (proc->state != PROC_TERMINATED) {
@@ -218,12 +216,13 @@ void display_system_status() {
             case PROC_READY: state_str = ""; break;
             case PROC_RUNNING: state_str = ""; break;
             case PROC_WAITING: state_str = "ȴ"; break;
+            case PROC_SUSPENDED: state_str = ""; break;
             case PROC_TERMINATED: state_str = "ֹ"; break;
             default: state_str = "δ֪";
             }
 
             log_printf("%-4d %-12s  %-8s  %4d    %4d       %4d\n",
-                proc->pid, proc->name, state_str,
+                proc->pid, process_info(proc)->name, state_str,
                 proc->memory_size, proc->remaining_time, proc->arrival_time);
         }
     }
@@ -246,21 +245,27 @@ void display_system_status() {
     log_printf("\n--- ״̬ ---\n");
     log_printf("㷨: %s\n", 
               g_scheduler.type == SCHED_FIFO ? "Ƚȳ(FIFO)" :
-              g_scheduler.type == SCHED_RR ? "ʱƬת(RR)" : "ȼ");
-    log_printf("н: %d\n", g_scheduler.ready_queue.count);
+              g_scheduler.type == SCHED_RR ? "ʱƬת(RR)" :
+              g_scheduler.type == SCHED_EDF ? "ֹ(EDF)" : "ȼ");
+    log_printf("н: %d\n", scheduler_ready_count());
     log_printf("ǰн: %s\n", 
               g_scheduler.current_process ? 
-              g_scheduler.current_process->name : "");
+              process_info(g_scheduler.current_process)->name : "");
     log_printf("ǰʱƬ: %d/%d\n", 
               g_scheduler.current_time_slice, g_scheduler.time_slice);
     log_printf("Q=˳, C=ڴ, F=״Ӧ, B=Ӧ, W=Ӧ\n");
     log_printf("...\n");
 }
 
-int main() {
+int main(int argc, char** argv) {
     // ʼ־
     init_logging();
 
+    // ѡķļ (layout_opt)
+    if (argc > 1 && partition_load_layout(argv[1]) != 0) {
+        log_printf("޷ط %sʹĬϲ\n", argv[1]);
+    }
+
     log_printf("=== ̶ڴϵͳ ===\n");
 
     // ȡǰʱ
@@ -357,21 +362,22 @@ int main() {
 
             // ÿѭƽһλʱ
             simulated_time++;
+            advance_time();
 
             // µĽ
             for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
                 process_t* proc = &process_table[i];
                 if (proc->state == PROC_CREATED && proc->arrival_time <= simulated_time) {
                     log_printf("\n %s (PID=%d) ʱ %d \n",
-                        proc->name, proc->pid, simulated_time);
+                        process_info(proc)->name, proc->pid, simulated_time);
 
                     // Էڴ
                     if (allocate_memory(proc, current_strategy) == 0) {
-                        log_printf("\nڴѷ %s\n", proc->name);
+                        log_printf("\nڴѷ %s\n", process_info(proc)->name);
                         scheduler_add_process(proc);  // ӵ
                     }
                     else {
-                        log_printf("ʱ޷Ϊ %s ڴ棬´γ\n", proc->name);
+                        log_printf("ʱ޷Ϊ %s ڴ棬´γ\n", process_info(proc)->name);
                         // PROC_CREATED״̬´ʱٳ
                     }
                 }
@@ -411,7 +417,7 @@ int main() {
     else {
         // ֶģʽ
         while (running) {
-            log_printf("\nƽʱ (Q=˳, C=ڴ): ");
+            log_printf("\nƽʱ (Q=˳, C=ڴ, S=, L=ָ): ");
             char key = get_char_input();
 
             if (key == 'q' || key == 'Q') {
@@ -422,6 +428,21 @@ int main() {
                 display_system_status();
                 continue;
             }
+            else if (key == 's' || key == 'S') {
+                if (kernel_snapshot(SNAPSHOT_FILE) == 0) {
+                    log_printf("\nѱ浽 %s\n", SNAPSHOT_FILE);
+                }
+                continue;
+            }
+            else if (key == 'l' || key == 'L') {
+                // ָӿʱ̼
+                if (kernel_restore(SNAPSHOT_FILE) == 0) {
+                    simulated_time = get_current_time();
+                    log_printf("\nѴ %s ָʱ %d\n", SNAPSHOT_FILE, simulated_time);
+                    display_system_status();
+                }
+                continue;
+            }
             else if (key == 'f' || key == 'F') {
                 current_strategy = FIRST_FIT;
             }
@@ -433,21 +454,21 @@ int main() {
             }
 
             simulated_time++;
+            advance_time();
 
             // µĽ
-            extern process_t process_table[MAX_PROCESSES];
             for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
                 process_t* proc = &process_table[i];
                 if (proc->state == PROC_CREATED && proc->arrival_time <= simulated_time) {
                     log_printf("\n %s (PID=%d) ʱ %d \n",
-                        proc->name, proc->pid, simulated_time);
+                        process_info(proc)->name, proc->pid, simulated_time);
 
                     if (allocate_memory(proc, current_strategy) == 0) {
-                        log_printf("ڴѷ %s\n", proc->name);
+                        log_printf("ڴѷ %s\n", process_info(proc)->name);
                         scheduler_add_process(proc);  // ӵ
                     }
                     else {
-                        log_printf("޷Ϊ %s ڴ\n", proc->name);
+                        log_printf("޷Ϊ %s ڴ\n", process_info(proc)->name);
                     }
                 }
             }
@@ -0,0 +1,206 @@
+#include "fp_alloc.h"
+#include "tagstack.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+struct fp_pool_t {
+    tag_stack_t free[FP_MAX_CLASSES];    // 各类的空闲块栈，元素为块号
+    uint32_t class_count;
+    uint32_t size[FP_MAX_CLASSES];       // 块大小，升序
+    uint32_t first[FP_MAX_CLASSES];      // 该类第一块的块号
+    uint8_t* base[FP_MAX_CLASSES];       // 该类第一块的地址 (各类按大小升序连续存放)
+    uint8_t* end;                        // 最后一类的末尾
+    uint32_t* next;                      // 空闲栈中的链接，按块号
+    void* mapping;                       // fp_create映射的区域，NULL表示调用者提供
+    size_t mapping_size;
+};
+
+static size_t align_up(size_t n) {
+    return (n + FP_ALIGN - 1) / FP_ALIGN * FP_ALIGN;
+}
+
+// 整理配置: 块大小取整、按大小升序、同样大小的类合并。返回类数，配置无效时返回0
+static uint32_t normalize(const fp_class_t* classes, uint32_t count, fp_class_t* out) {
+    uint32_t n = 0;
+    uint64_t blocks = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (classes[i].size == 0 || classes[i].count == 0) continue;
+        if (classes[i].size > 0xFFFFFFFFu - FP_ALIGN) return 0;
+        uint32_t size = (uint32_t)align_up(classes[i].size);
+        uint32_t c = 0;
+        while (c < n && out[c].size < size) c++;
+        if (c < n && out[c].size == size) {
+            out[c].count += classes[i].count;
+        } else {
+            if (n == FP_MAX_CLASSES) return 0;
+            for (uint32_t k = n; k > c; k--) {
+                out[k] = out[k - 1];
+            }
+            out[c].size = size;
+            out[c].count = classes[i].count;
+            n++;
+        }
+        blocks += classes[i].count;
+    }
+    // 块号为32位，TAG_STACK_EMPTY保留
+    return blocks < TAG_STACK_EMPTY ? n : 0;
+}
+
+// 元数据 (池结构和链接数组) 的大小
+static size_t meta_size(const fp_class_t* classes, uint32_t n) {
+    size_t blocks = 0;
+    for (uint32_t c = 0; c < n; c++) {
+        blocks += classes[c].count;
+    }
+    return align_up(sizeof(fp_pool_t)) + align_up(blocks * sizeof(uint32_t));
+}
+
+size_t fp_region_size(const fp_class_t* classes, uint32_t count) {
+    fp_class_t norm[FP_MAX_CLASSES];
+    uint32_t n = normalize(classes, count, norm);
+    if (!n) return 0;
+
+    size_t total = meta_size(norm, n);
+    for (uint32_t c = 0; c < n; c++) {
+        total += (size_t)norm[c].size * norm[c].count;
+    }
+    return total;
+}
+
+static void* map_region(size_t size) {
+#ifdef _WIN32
+    return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
+#endif
+}
+
+static void unmap_region(void* p, size_t size) {
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, size);
+#endif
+}
+
+fp_pool_t* fp_create(void* region, size_t region_size, const fp_class_t* classes, uint32_t count) {
+    fp_class_t norm[FP_MAX_CLASSES];
+    uint32_t n = normalize(classes, count, norm);
+    size_t need = n ? fp_region_size(norm, n) : 0;
+    void* mapping = NULL;
+
+    if (!need) return NULL;
+    if (!region) {
+        region = mapping = map_region(need);
+        region_size = need;
+        if (!region) return NULL;
+    }
+    if (region_size < need || (uintptr_t)region % FP_ALIGN != 0) return NULL;
+
+    fp_pool_t* pool = (fp_pool_t*)region;
+    uint8_t* p = (uint8_t*)region + align_up(sizeof(fp_pool_t));
+    pool->class_count = n;
+    pool->next = (uint32_t*)p;
+    pool->mapping = mapping;
+    pool->mapping_size = mapping ? need : 0;
+
+    // 块区在元数据之后，各类按大小升序连续存放
+    p = (uint8_t*)region + meta_size(norm, n);
+    uint32_t id = 0;
+    for (uint32_t c = 0; c < n; c++) {
+        pool->size[c] = norm[c].size;
+        pool->first[c] = id;
+        pool->base[c] = p;
+        p += (size_t)norm[c].size * norm[c].count;
+        id += norm[c].count;
+    }
+    pool->end = p;
+
+    // 每类的块按地址顺序链成栈，先分配低地址的块
+    for (uint32_t c = 0; c < FP_MAX_CLASSES; c++) {
+        tag_stack_init(&pool->free[c]);
+    }
+    for (uint32_t c = 0; c < n; c++) {
+        uint32_t last = pool->first[c] + norm[c].count - 1;
+        for (uint32_t b = pool->first[c]; b < last; b++) {
+            pool->next[b] = b + 1;
+        }
+        tag_stack_push_chain(&pool->free[c], pool->next, pool->first[c], last, NULL);
+    }
+    return pool;
+}
+
+void fp_destroy(fp_pool_t* pool) {
+    if (pool && pool->mapping) {
+        unmap_region(pool->mapping, pool->mapping_size);
+    }
+}
+
+void* fp_alloc(fp_pool_t* pool, size_t size) {
+    uint32_t c = 0;
+    while (c < pool->class_count && pool->size[c] < size) c++;
+    return fp_alloc_class(pool, c);
+}
+
+void* fp_alloc_class(fp_pool_t* pool, uint32_t c) {
+    for (; c < pool->class_count; c++) {
+        uint32_t b = tag_stack_pop(&pool->free[c], pool->next, NULL);
+        if (b != TAG_STACK_EMPTY) {
+            return pool->base[c] + (size_t)(b - pool->first[c]) * pool->size[c];
+        }
+    }
+    return NULL;
+}
+
+// 指针所在的类，不在块区或不是块的起始地址时返回FP_MAX_CLASSES
+static uint32_t class_of(const fp_pool_t* pool, const uint8_t* p, uint32_t* block) {
+    if (p < pool->base[0] || p >= pool->end) return FP_MAX_CLASSES;
+
+    uint32_t c = pool->class_count - 1;
+    while (p < pool->base[c]) c--;
+    size_t off = (size_t)(p - pool->base[c]);
+    if (off % pool->size[c] != 0) return FP_MAX_CLASSES;
+    *block = pool->first[c] + (uint32_t)(off / pool->size[c]);
+    return c;
+}
+
+void fp_free(fp_pool_t* pool, void* ptr) {
+    uint32_t b;
+    uint32_t c = ptr ? class_of(pool, (const uint8_t*)ptr, &b) : FP_MAX_CLASSES;
+    if (c == FP_MAX_CLASSES) return;
+    tag_stack_push(&pool->free[c], pool->next, b, NULL);
+}
+
+size_t fp_usable_size(const fp_pool_t* pool, const void* ptr) {
+    uint32_t b;
+    uint32_t c = ptr ? class_of(pool, (const uint8_t*)ptr, &b) : FP_MAX_CLASSES;
+    return c == FP_MAX_CLASSES ? 0 : pool->size[c];
+}
+
+uint32_t fp_class_count(const fp_pool_t* pool) {
+    return pool->class_count;
+}
+
+uint32_t fp_classes_from_layout(const uint32_t* sizes, uint32_t n, uint32_t scale, fp_class_t* classes, uint32_t max) {
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t c = 0;
+        while (c < count && classes[c].size != sizes[i]) c++;
+        if (c == count) {
+            if (count == max) return 0;
+            classes[count].size = sizes[i];
+            classes[count].count = 0;
+            count++;
+        }
+        classes[c].count += scale;
+    }
+    return count;
+}
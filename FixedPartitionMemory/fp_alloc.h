@@ -0,0 +1,42 @@
+#ifndef _FP_ALLOC_H
+#define _FP_ALLOC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 固定分区分配器库 (不依赖模拟内核，可单独编译链接到实际程序)
+// 与模拟的固定分区模型相同: 一块内存预先切成若干大小类的固定大小块，每类的块大小和块数由配置给出
+// (可由分区布局 FIXED_PARTITION_SIZES / layout_opt 的输出换算，见 fp_classes_from_layout)。
+// fp_alloc(n) 从能容纳n的最小类取一块，该类用完时用更大的类，都没有时返回NULL；fp_free 把块放回所属类。
+// 分配和释放不调用系统分配器，时间只与类数有关；块大小固定，没有外部碎片，内部碎片不超过块大小减请求。
+// 每类的空闲块在无锁栈中 (tagstack.h)，多个线程可以并发分配和释放。
+// 块大小向上取整为 FP_ALIGN 的倍数，块地址按 FP_ALIGN 对齐。重复释放和释放非本池的指针的行为未定义
+#define FP_MAX_CLASSES 32
+#define FP_ALIGN 16
+
+typedef struct fp_class_t {
+    uint32_t size;     // 块大小 (字节)
+    uint32_t count;    // 块数
+} fp_class_t;
+
+typedef struct fp_pool_t fp_pool_t;
+
+// 按配置建池所需的区域大小 (含池的元数据)，配置无效时返回0
+size_t fp_region_size(const fp_class_t* classes, uint32_t count);
+// 在region上建池 (region为NULL时映射一块匿名内存)；region按FP_ALIGN对齐、至少fp_region_size()字节，
+// 池的元数据放在region开头。配置无效或区域太小时返回NULL
+fp_pool_t* fp_create(void* region, size_t region_size, const fp_class_t* classes, uint32_t count);
+void fp_destroy(fp_pool_t* pool);    // 只解除fp_create映射的区域，调用者提供的区域由调用者释放
+void* fp_alloc(fp_pool_t* pool, size_t size);
+// 从第cls类 (按块大小升序编号) 取一块，该类用完时用更大的类；cls不小于类数时返回NULL。
+// 大小到类的查找在调用者中完成 (见fp_layout.h的编译期查找表)
+void* fp_alloc_class(fp_pool_t* pool, uint32_t cls);
+void fp_free(fp_pool_t* pool, void* ptr);
+size_t fp_usable_size(const fp_pool_t* pool, const void* ptr);   // 块大小，非本池指针返回0
+uint32_t fp_class_count(const fp_pool_t* pool);
+
+// 把分区布局 (每个分区的大小) 换算成大小类: 相同大小的分区合成一类，块数为分区个数乘scale。
+// 返回类数，超过max时返回0
+uint32_t fp_classes_from_layout(const uint32_t* sizes, uint32_t n, uint32_t scale, fp_class_t* classes, uint32_t max);
+
+#endif // _FP_ALLOC_H
@@ -0,0 +1,86 @@
+#ifndef _FP_LAYOUT_H
+#define _FP_LAYOUT_H
+
+#include "fp_alloc.h"
+
+// 编译期生成的固定分区布局 (仅用于 fp_alloc 库)
+// 布局描述是一个宏，对每个大小类调用 X(arg, 块大小, 块数)，块大小按升序且取整到FP_ALIGN后互不相同:
+//   #define MY_LAYOUT(X, arg) X(arg, 32, 64) X(arg, 64, 32) X(arg, 256, 8)
+//   FP_DEFINE_LAYOUT(my, MY_LAYOUT)
+// 展开为:
+//   my_classes[] / my_class_count          大小类配置
+//   my_class_of[]                          大小到类的查找表，按FP_ALIGN粒度索引，在编译期由布局算出
+//   my_region_size(scale)                  每类块数乘scale时建池所需的区域大小
+//   my_create(region, region_size, scale)  按布局建池 (参数同fp_create)
+//   my_alloc(pool, size)                   查表得到类后从该类取块，快路径上没有按大小的比较
+// 每个布局是一组独立的静态表和内联函数，不同布局可以在同一程序中并存。
+// 查找表覆盖到 FP_LOOKUP_MAX 字节，布局中的块大小不能超过它 (编译期检查)
+#define FP_LOOKUP_MAX 4096
+#define FP_LOOKUP_SLOTS (FP_LOOKUP_MAX / FP_ALIGN + 2)   // 最后一项对应超过FP_LOOKUP_MAX的请求
+
+// 预定义布局: partition.c 的预定义分区大小 (4个96字节、4个128字节)
+#define FP_LAYOUT_PARTITIONS(X, arg) X(arg, 96, 4) X(arg, 128, 4)
+// 预定义布局: 16到4096字节的2的幂，每类块数相同
+#define FP_LAYOUT_POW2(X, arg) X(arg, 16, 1) X(arg, 32, 1) X(arg, 64, 1) X(arg, 128, 1) X(arg, 256, 1) \
+    X(arg, 512, 1) X(arg, 1024, 1) X(arg, 2048, 1) X(arg, 4096, 1)
+
+#define FP_ROUND_SIZE(size) (((size) + FP_ALIGN - 1) / FP_ALIGN * FP_ALIGN)
+
+// 布局描述的各个展开
+#define FP_LAYOUT_CLASS(arg, size, count) { (size), (count) },
+#define FP_LAYOUT_ONE(arg, size, count) + 1
+#define FP_LAYOUT_TOO_BIG(arg, size, count) + ((size) > FP_LOOKUP_MAX)
+#define FP_LAYOUT_BELOW(slot, size, count) + (FP_ROUND_SIZE(size) < (slot) * FP_ALIGN)
+
+// 查找表第slot项: 块大小小于 slot * FP_ALIGN 的类数，即能容纳 ((slot-1)*FP_ALIGN, slot*FP_ALIGN] 的最小类
+#define FP_LOOKUP_ENTRY(LAYOUT, slot) (uint8_t)(0 LAYOUT(FP_LAYOUT_BELOW, (slot))),
+#define FP_LOOKUP_16(LAYOUT, b) \
+    FP_LOOKUP_ENTRY(LAYOUT, (b) + 0) FP_LOOKUP_ENTRY(LAYOUT, (b) + 1) FP_LOOKUP_ENTRY(LAYOUT, (b) + 2) \
+    FP_LOOKUP_ENTRY(LAYOUT, (b) + 3) FP_LOOKUP_ENTRY(LAYOUT, (b) + 4) FP_LOOKUP_ENTRY(LAYOUT, (b) + 5) \
+    FP_LOOKUP_ENTRY(LAYOUT, (b) + 6) FP_LOOKUP_ENTRY(LAYOUT, (b) + 7) FP_LOOKUP_ENTRY(LAYOUT, (b) + 8) \
+    FP_LOOKUP_ENTRY(LAYOUT, (b) + 9) FP_LOOKUP_ENTRY(LAYOUT, (b) + 10) FP_LOOKUP_ENTRY(LAYOUT, (b) + 11) \
+    FP_LOOKUP_ENTRY(LAYOUT, (b) + 12) FP_LOOKUP_ENTRY(LAYOUT, (b) + 13) FP_LOOKUP_ENTRY(LAYOUT, (b) + 14) \
+    FP_LOOKUP_ENTRY(LAYOUT, (b) + 15)
+#define FP_LOOKUP_256(LAYOUT) \
+    FP_LOOKUP_16(LAYOUT, 0) FP_LOOKUP_16(LAYOUT, 16) FP_LOOKUP_16(LAYOUT, 32) FP_LOOKUP_16(LAYOUT, 48) \
+    FP_LOOKUP_16(LAYOUT, 64) FP_LOOKUP_16(LAYOUT, 80) FP_LOOKUP_16(LAYOUT, 96) FP_LOOKUP_16(LAYOUT, 112) \
+    FP_LOOKUP_16(LAYOUT, 128) FP_LOOKUP_16(LAYOUT, 144) FP_LOOKUP_16(LAYOUT, 160) FP_LOOKUP_16(LAYOUT, 176) \
+    FP_LOOKUP_16(LAYOUT, 192) FP_LOOKUP_16(LAYOUT, 208) FP_LOOKUP_16(LAYOUT, 224) FP_LOOKUP_16(LAYOUT, 240)
+#define FP_LOOKUP_TABLE(LAYOUT) \
+    FP_LOOKUP_256(LAYOUT) FP_LOOKUP_ENTRY(LAYOUT, 256) FP_LOOKUP_ENTRY(LAYOUT, 257)
+
+// 请求大小对应的查找表下标 (超过FP_LOOKUP_MAX的都落在最后一项)
+static inline uint32_t fp_lookup_slot(size_t size) {
+    size_t slot = size / FP_ALIGN + (size % FP_ALIGN != 0);
+    return slot < FP_LOOKUP_SLOTS - 1 ? (uint32_t)slot : FP_LOOKUP_SLOTS - 1;
+}
+
+#define FP_DEFINE_LAYOUT(name, LAYOUT) \
+    static const fp_class_t name##_classes[] = { LAYOUT(FP_LAYOUT_CLASS, 0) }; \
+    enum { name##_class_count = 0 LAYOUT(FP_LAYOUT_ONE, 0) }; \
+    _Static_assert(name##_class_count <= FP_MAX_CLASSES, #name ": too many size classes"); \
+    _Static_assert((0 LAYOUT(FP_LAYOUT_TOO_BIG, 0)) == 0, #name ": block size exceeds FP_LOOKUP_MAX"); \
+    static const uint8_t name##_class_of[FP_LOOKUP_SLOTS] = { FP_LOOKUP_TABLE(LAYOUT) }; \
+    /* 块大小不是升序或取整后重复时，池中的类与查找表不一致，返回0 */ \
+    static inline int name##_scaled(fp_class_t* classes, uint32_t scale) { \
+        for (uint32_t i = 0; i < name##_class_count; i++) { \
+            classes[i].size = name##_classes[i].size; \
+            classes[i].count = name##_classes[i].count * scale; \
+            if (i && FP_ROUND_SIZE(classes[i].size) <= FP_ROUND_SIZE(classes[i - 1].size)) return 0; \
+        } \
+        return 1; \
+    } \
+    static inline size_t name##_region_size(uint32_t scale) { \
+        fp_class_t classes[name##_class_count]; \
+        return name##_scaled(classes, scale) ? fp_region_size(classes, name##_class_count) : 0; \
+    } \
+    static inline fp_pool_t* name##_create(void* region, size_t region_size, uint32_t scale) { \
+        fp_class_t classes[name##_class_count]; \
+        if (!name##_scaled(classes, scale)) return NULL; \
+        return fp_create(region, region_size, classes, name##_class_count); \
+    } \
+    static inline void* name##_alloc(fp_pool_t* pool, size_t size) { \
+        return fp_alloc_class(pool, name##_class_of[fp_lookup_slot(size)]); \
+    }
+
+#endif // _FP_LAYOUT_H
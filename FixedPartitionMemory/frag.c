@@ -0,0 +1,95 @@
+#include "os_types.h"
+#include "frag.h"
+#include "memory.h"
+#include "config.h"
+#include "kernel.h"
+
+// 统计状态位于当前内核上下文
+#define FRAG (kernel_ctx_current()->frag)
+
+void frag_reset(void) {
+    memset(&FRAG.stats, 0, sizeof(FRAG.stats));
+    FRAG.internal_sum = 0;
+    FRAG.external_sum = 0;
+    FRAG.series_count = 0;
+    FRAG.series_interval = 1;
+    FRAG.next_sample_time = 0;
+}
+
+void frag_on_allocate(const partition_t* part, uint32_t requested) {
+    uint32_t waste = part->size - requested;
+
+    FRAG.stats.allocations++;
+    FRAG.stats.waste_total += waste;
+    if (waste > FRAG.stats.waste_max) FRAG.stats.waste_max = waste;
+    FRAG.stats.waste_current += waste;
+    FRAG.stats.allocated_current += part->size;
+}
+
+void frag_on_free(const partition_t* part) {
+    FRAG.stats.waste_current -= part->size - part->used_size;
+    FRAG.stats.allocated_current -= part->size;
+}
+
+void frag_on_failure(uint32_t requested) {
+    FRAG.stats.alloc_failures++;
+    if (get_total_free_memory() >= requested) {
+        FRAG.stats.failures_despite_free++;
+    }
+}
+
+double frag_external(uint32_t free_bytes, uint32_t largest_free) {
+    return free_bytes ? (double)(free_bytes - largest_free) / free_bytes : 0.0;
+}
+
+// 序列已满: 保留偶数位置的采样，间隔翻倍
+static void series_decimate(void) {
+    for (uint32_t i = 0; i < FRAG.series_count / 2; i++) {
+        FRAG.series[i] = FRAG.series[i * 2];
+    }
+    FRAG.series_count /= 2;
+    FRAG.series_interval *= 2;
+    FRAG.next_sample_time = FRAG.series[FRAG.series_count - 1].time + FRAG.series_interval;
+}
+
+void frag_sample(uint32_t time) {
+    uint32_t free_bytes = get_total_free_memory();
+    uint32_t largest = get_largest_free_block();
+
+    FRAG.stats.samples++;
+    if (FRAG.stats.allocated_current) {
+        FRAG.internal_sum += (double)FRAG.stats.waste_current / FRAG.stats.allocated_current;
+    }
+    FRAG.external_sum += frag_external(free_bytes, largest);
+
+    if (time < FRAG.next_sample_time) return;
+    if (FRAG.series_count == FRAG_SERIES_SIZE) {
+        series_decimate();
+        if (time < FRAG.next_sample_time) return;
+    }
+
+    frag_sample_t* s = &FRAG.series[FRAG.series_count++];
+    s->time = time;
+    s->allocated_bytes = FRAG.stats.allocated_current;
+    s->internal_waste = FRAG.stats.waste_current;
+    s->free_bytes = free_bytes;
+    s->largest_free = largest;
+    s->failures_despite_free = (uint32_t)FRAG.stats.failures_despite_free;
+    FRAG.next_sample_time = time + FRAG.series_interval;
+}
+
+void frag_get_stats(frag_stats_t* out) {
+    *out = FRAG.stats;
+    out->mean_internal_frag = FRAG.stats.samples ? FRAG.internal_sum / FRAG.stats.samples : 0;
+    out->mean_external_frag = FRAG.stats.samples ? FRAG.external_sum / FRAG.stats.samples : 0;
+}
+
+uint32_t frag_get_series(frag_sample_t* out, uint32_t max) {
+    uint32_t n = FRAG.series_count < max ? FRAG.series_count : max;
+    memcpy(out, FRAG.series, sizeof(frag_sample_t) * n);
+    return n;
+}
+
+uint32_t frag_sample_interval(void) {
+    return FRAG.series_interval;
+}
@@ -0,0 +1,60 @@
+#ifndef _FRAG_H
+#define _FRAG_H
+
+#include "os_types.h"
+#include "partition.h"
+#include "config.h"
+
+// 碎片统计：记录每次分配的内部浪费、外部碎片和"总空闲足够却分配失败"的次数，
+// 并在每个时间单位结束时采样，形成整个运行过程的时间序列
+
+// 时间序列采样点
+typedef struct frag_sample_t {
+    uint32_t time;
+    uint32_t allocated_bytes;        // 已分配分区总大小
+    uint32_t internal_waste;         // 已分配分区中进程未使用的字节
+    uint32_t free_bytes;             // 空闲分区总大小
+    uint32_t largest_free;           // 最大空闲分区
+    uint32_t failures_despite_free;  // 截至此刻的累计次数
+} frag_sample_t;
+
+// 整个运行的汇总
+typedef struct frag_stats_t {
+    uint64_t allocations;            // 成功分配次数
+    uint64_t waste_total;            // 每次分配的内部浪费之和
+    uint32_t waste_max;              // 单次分配的最大浪费
+    uint32_t waste_current;          // 当前驻留进程的内部浪费
+    uint32_t allocated_current;      // 当前已分配分区总大小
+    uint64_t alloc_failures;         // 分配失败次数
+    uint64_t failures_despite_free;  // 其中总空闲 >= 请求大小的次数
+    uint64_t samples;                // 采样次数 (含被抽稀的)
+    double mean_internal_frag;       // 采样平均: 内部浪费 / 已分配
+    double mean_external_frag;       // 采样平均: 1 - 最大空闲块 / 总空闲
+} frag_stats_t;
+
+// 碎片统计状态 (每个内核上下文一份)
+typedef struct frag_state_t {
+    frag_stats_t stats;
+    double internal_sum;
+    double external_sum;
+    frag_sample_t series[FRAG_SERIES_SIZE];
+    uint32_t series_count;
+    uint32_t series_interval;        // 当前采样间隔 (每次抽稀翻倍)
+    uint32_t next_sample_time;
+} frag_state_t;
+
+void frag_reset(void);
+void frag_on_allocate(const partition_t* part, uint32_t requested);
+void frag_on_free(const partition_t* part);
+void frag_on_failure(uint32_t requested);
+void frag_sample(uint32_t time);
+void frag_get_stats(frag_stats_t* stats);
+
+// 按时间顺序取出采样 (序列满时隔点抽稀，因此始终覆盖整个运行)，返回个数
+uint32_t frag_get_series(frag_sample_t* out, uint32_t max);
+uint32_t frag_sample_interval(void);
+
+// 外部碎片率: 空闲内存中不属于最大空闲块的比例
+double frag_external(uint32_t free_bytes, uint32_t largest_free);
+
+#endif // _FRAG_H
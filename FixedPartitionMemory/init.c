@@ -4,16 +4,55 @@
 #include "partition.h"
 #include "memory.h"
 #include "config.h"
+#include "frag.h"
+#include "adapt.h"
+#include "kernel.h"
+#include "physmem.h"
+#include "io.h"
+#include "swap.h"
+#include <stdlib.h>
 
-// ȫڴ״̬
-static uint8_t system_memory[MEMORY_SIZE];
-static uint32_t current_time = 0;
+// Ĭģδkernel_ctx_bind()̶߳ʹ
+static kernel_ctx_t default_ctx;
+KERNEL_THREAD_LOCAL kernel_ctx_t* kernel_ctx_tls = &default_ctx;
+
+// ʱλڵǰں
+#define current_time (kernel_ctx_current()->current_time)
+
+kernel_ctx_t* kernel_ctx_create(void) {
+    return (kernel_ctx_t*)calloc(1, sizeof(kernel_ctx_t));
+}
+
+void kernel_ctx_destroy(kernel_ctx_t* ctx) {
+    if (!ctx) return;
+
+    // ӳҪȰ󶨸
+    kernel_ctx_t* prev = kernel_ctx_bind(ctx);
+    physmem_unmap();
+    swap_close();
+    kernel_ctx_tls = (prev == ctx) ? &default_ctx : prev;
+    if (ctx != &default_ctx) {
+        free(ctx);
+    }
+}
+
+kernel_ctx_t* kernel_ctx_bind(kernel_ctx_t* ctx) {
+    kernel_ctx_t* prev = kernel_ctx_tls;
+    kernel_ctx_tls = ctx ? ctx : &default_ctx;
+    return prev;
+}
 
 // ں˳ʼ
 void kernel_init(void) {
+    current_time = 0;
     kernel_log_init();
     kernel_log(LOG_INFO, "Kernel initialization started");
 
+    // ӳģڴ (ӳʱԭ)
+    if (physmem_map() != 0) {
+        kernel_panic("Cannot map physical memory");
+    }
+
     // ʼ̹
     process_init();
     kernel_log(LOG_INFO, "Process management initialized");
@@ -36,13 +75,20 @@ uint32_t get_current_time(void) {
 
 // ƽʱ
 void advance_time(void) {
+    io_tick(current_time);
+    swap_tick(current_time);
+    adapt_tick(current_time);
+    frag_sample(current_time);
     current_time++;
     kernel_log(LOG_DEBUG, "Time advanced to %d", current_time);
 }
 
 // ȡڴָ
 uint8_t* get_memory_base(void) {
-    return system_memory;
+    if (!kernel_ctx_current()->mem.base) {
+        physmem_map();
+    }
+    return kernel_ctx_current()->mem.base;
 }
 
 // ȡڴС
@@ -0,0 +1,212 @@
+#include "os_types.h"
+#include "config.h"
+#include "log.h"
+#include "kernel.h"
+#include "io.h"
+#include "swap.h"
+
+// 设备状态位于当前内核上下文
+#define IO (kernel_ctx_current()->io)
+
+void io_set_service_time(uint32_t ticks) {
+    IO.service_time = ticks ? ticks : IO_SERVICE_TIME;
+}
+
+uint32_t io_get_service_time(void) {
+    return IO.service_time ? IO.service_time : IO_SERVICE_TIME;
+}
+
+void io_set_scheduler(io_sched_t s) {
+    IO.sched = s < IO_SCHED_COUNT ? s : IO_SCHED_FIFO;
+}
+
+io_sched_t io_get_scheduler(void) {
+    return IO.sched;
+}
+
+const char* io_sched_name(io_sched_t s) {
+    switch (s) {
+        case IO_SCHED_FIFO: return "fifo";
+        case IO_SCHED_SSTF: return "sstf";
+        case IO_SCHED_SCAN: return "scan";
+        case IO_SCHED_CLOOK: return "clook";
+        case IO_SCHED_DEADLINE: return "deadline";
+        default: return "unknown";
+    }
+}
+
+void io_reset(void) {
+    if (!IO.service_time) IO.service_time = IO_SERVICE_TIME;
+    proc_queue_init(&IO.queue);
+    IO.active = PROC_NONE;
+    IO.service_left = 0;
+    IO.head = 0;
+    IO.direction = 1;
+    memset(&IO.stats, 0, sizeof(IO.stats));
+}
+
+// 第k个请求访问的磁道: 由PID和k散列得到
+static uint32_t request_track(uint32_t pid, uint32_t k) {
+    uint32_t x = pid * 2654435761u ^ (k + 1) * 40503u;
+    x ^= x >> 15;
+    x *= 2246822519u;
+    x ^= x >> 13;
+    return x % DISK_TRACKS;
+}
+
+static uint32_t track_of(uint32_t slot) {
+    return process_info_table[slot].io_track;
+}
+
+static uint32_t distance(uint32_t a, uint32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// 调度算法: 返回队列中下一个要服务的进程下标 (队列非空)
+// 距离相同时取先发出的请求
+static uint32_t pick_fifo(void) {
+    return IO.queue.front;
+}
+
+static uint32_t pick_sstf(void) {
+    uint32_t best = IO.queue.front;
+    for (uint32_t i = IO.queue.front; i != PROC_NONE; i = process_table[i].next) {
+        if (distance(track_of(i), IO.head) < distance(track_of(best), IO.head)) best = i;
+    }
+    return best;
+}
+
+// 沿dir方向 (含当前磁道) 最近的请求，没有时返回PROC_NONE
+static uint32_t nearest_ahead(int dir) {
+    uint32_t best = PROC_NONE;
+    for (uint32_t i = IO.queue.front; i != PROC_NONE; i = process_table[i].next) {
+        uint32_t t = track_of(i);
+        if (dir > 0 ? t < IO.head : t > IO.head) continue;
+        if (best == PROC_NONE || distance(t, IO.head) < distance(track_of(best), IO.head)) best = i;
+    }
+    return best;
+}
+
+static uint32_t pick_scan(void) {
+    uint32_t next = nearest_ahead(IO.direction);
+    if (next == PROC_NONE) {
+        IO.direction = -IO.direction;
+        next = nearest_ahead(IO.direction);
+    }
+    return next;
+}
+
+static uint32_t pick_clook(void) {
+    uint32_t next = nearest_ahead(1);
+    if (next == PROC_NONE) {
+        // 跳回磁道号最小的请求
+        next = IO.queue.front;
+        for (uint32_t i = IO.queue.front; i != PROC_NONE; i = process_table[i].next) {
+            if (track_of(i) < track_of(next)) next = i;
+        }
+    }
+    return next;
+}
+
+static uint32_t pick_deadline(void) {
+    // 队列按发出顺序，队首等待最久
+    if (get_current_time() - process_info_table[IO.queue.front].io_start >= IO_DEADLINE) {
+        return IO.queue.front;
+    }
+    return pick_clook();
+}
+
+static uint32_t (*const pickers[IO_SCHED_COUNT])(void) = {
+    pick_fifo, pick_sstf, pick_scan, pick_clook, pick_deadline
+};
+
+// 磁盘空闲时按调度算法取出下一个请求开始服务
+static void start_next(void) {
+    if (IO.active != PROC_NONE || !IO.queue.count) return;
+
+    uint32_t slot = pickers[IO.sched]();
+    uint32_t seek = distance(track_of(slot), IO.head);
+    proc_queue_remove(&IO.queue, &process_table[slot]);
+    IO.active = slot;
+    IO.head = track_of(slot);
+    IO.service_left = IO.service_time + (seek + DISK_SEEK_SPEED - 1) / DISK_SEEK_SPEED;
+    IO.stats.seek_tracks += seek;
+}
+
+int io_check_block(process_t* proc) {
+    process_info_t* info = process_info(proc);
+
+    if (info->io_issued >= info->io_requests) return 0;
+
+    // 第k个请求在执行了 k * burst / (io_requests + 1) 个时间单位后发出
+    uint32_t executed = info->burst_time - proc->remaining_time;
+    if ((uint64_t)executed * (info->io_requests + 1) < (uint64_t)(info->io_issued + 1) * info->burst_time) {
+        return 0;
+    }
+
+    info->io_track = request_track(proc->pid, info->io_issued);
+    info->io_issued++;
+    info->io_start = get_current_time();
+    process_set_state(proc, PROC_WAITING);
+    proc_queue_push(&IO.queue, proc);
+    if (IO.queue.count > IO.stats.max_queue) IO.stats.max_queue = IO.queue.count;
+    IO.stats.requests++;
+
+    DEBUG_PRINT("Process %d blocked on I/O (%d/%d, track %d)", proc->pid, info->io_issued, info->io_requests,
+        info->io_track);
+    return 1;
+}
+
+void io_cancel(process_t* proc) {
+    if (proc->state != PROC_WAITING) return;
+
+    uint32_t slot = (uint32_t)(proc - process_table);
+    if (slot == IO.active) {
+        IO.active = PROC_NONE;
+        start_next();
+    } else if (proc_queue_contains(&IO.queue, proc)) {
+        proc_queue_remove(&IO.queue, proc);
+    }
+}
+
+void io_tick(uint32_t now) {
+    // 本时间单位刚发出的请求由下面的start_next()选入，从下个时间单位开始服务
+    if (IO.active != PROC_NONE) {
+        IO.stats.busy_ticks++;
+        if (--IO.service_left == 0) {
+            // 请求完成，进程在下个时间单位重新参与调度
+            process_t* proc = &process_table[IO.active];
+            process_info_t* info = process_info(proc);
+            uint32_t latency = now - info->io_start;
+            info->io_time += latency;
+            IO.stats.blocked_ticks += latency;
+            IO.stats.latency_hist[latency < IO_LATENCY_BUCKETS ? latency : IO_LATENCY_BUCKETS - 1]++;
+            if (latency > IO.stats.max_latency) IO.stats.max_latency = latency;
+            IO.stats.completed++;
+            IO.active = PROC_NONE;
+            if (info->swapped) {
+                swap_on_io_done(proc);
+            } else {
+                scheduler_add_process(proc);
+            }
+        }
+    }
+    start_next();
+}
+
+void io_get_stats(io_stats_t* out) {
+    *out = IO.stats;
+}
+
+uint32_t io_latency_percentile(const io_stats_t* s, double p) {
+    if (!s->completed) return 0;
+
+    uint64_t rank = (uint64_t)(p * s->completed + 0.5);
+    if (rank < 1) rank = 1;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < IO_LATENCY_BUCKETS - 1; i++) {
+        seen += s->latency_hist[i];
+        if (seen >= rank) return i;
+    }
+    return s->max_latency;
+}
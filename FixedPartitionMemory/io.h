@@ -0,0 +1,63 @@
+#ifndef _IO_H
+#define _IO_H
+
+#include "os_types.h"
+#include "config.h"
+#include "process.h"
+
+// I/O阻塞模型: 模拟磁盘
+// 进程的 io_requests 个I/O请求均匀分布在执行时间中：运行到请求点时发出请求，
+// 进入 PROC_WAITING 并排入设备队列；磁盘每次服务一个请求，服务时间为
+// 寻道时间 (磁头移动距离 / DISK_SEEK_SPEED，向上取整) 加 service_time，
+// 完成后进程回到就绪队列 (已换出的进程进入交换队列)。设备与CPU并行工作。
+// 每执行一个时间单位至多发出一个请求，执行时间为n时最多n-1个请求生效
+
+// I/O调度算法: 磁盘空闲时从队列中选下一个请求
+typedef enum {
+    IO_SCHED_FIFO,       // 按发出顺序
+    IO_SCHED_SSTF,       // 最短寻道优先
+    IO_SCHED_SCAN,       // 电梯算法 (LOOK: 沿当前方向服务，前方没有请求时掉头)
+    IO_SCHED_CLOOK,      // 单向电梯 (C-LOOK: 只向磁道号增大方向服务，到头后跳回最小的请求)
+    IO_SCHED_DEADLINE,   // 按C-LOOK顺序，等待超过IO_DEADLINE的最早请求优先
+    IO_SCHED_COUNT
+} io_sched_t;
+
+#define IO_LATENCY_BUCKETS 256   // 延迟直方图，每个时间单位一个桶，最后一个桶收集更长的延迟
+
+typedef struct io_stats_t {
+    uint64_t requests;       // 发出的请求数
+    uint64_t completed;      // 完成的请求数
+    uint64_t busy_ticks;     // 设备忙碌的时间单位
+    uint64_t blocked_ticks;  // 进程阻塞在I/O上的总时间 (排队 + 服务)，即延迟之和
+    uint64_t seek_tracks;    // 磁头移动的总磁道数
+    uint32_t max_latency;
+    uint32_t max_queue;      // 设备队列最大长度
+    uint32_t latency_hist[IO_LATENCY_BUCKETS];
+} io_stats_t;
+
+// I/O设备状态 (每个内核上下文一份)
+typedef struct io_state_t {
+    uint32_t service_time;   // 每个请求除寻道外的服务时间 (旋转 + 传输)
+    io_sched_t sched;        // 调度算法
+    proc_queue_t queue;      // 等待服务的请求 (按发出顺序)
+    uint32_t active;         // 正在服务的进程下标 (PROC_NONE表示空闲)
+    uint32_t service_left;   // 当前请求剩余的服务时间
+    uint32_t head;           // 磁头所在磁道
+    int direction;           // SCAN的移动方向: 1向磁道号增大，-1向减小
+    io_stats_t stats;
+} io_state_t;
+
+// 设置服务时间和调度算法，下次kernel_init()后生效 (service_time为0时取config.h默认值)
+void io_set_service_time(uint32_t ticks);
+uint32_t io_get_service_time(void);
+void io_set_scheduler(io_sched_t sched);
+io_sched_t io_get_scheduler(void);
+const char* io_sched_name(io_sched_t sched);
+void io_reset(void);
+int io_check_block(process_t* proc);   // 运行中的进程执行一个时间单位后调用，到达请求点时阻塞进程并返回1
+void io_cancel(process_t* proc);       // 把等待中的进程移出设备
+void io_tick(uint32_t now);            // 每个时间单位结束时推进设备
+void io_get_stats(io_stats_t* stats);
+uint32_t io_latency_percentile(const io_stats_t* stats, double p);   // 延迟分位数 (p取0..1)
+
+#endif // _IO_H
@@ -6,6 +6,62 @@
 #include "process.h"
 #include "partition.h"
 #include "memory.h"
+#include "scheduler.h"
+#include "frag.h"
+#include "adapt.h"
+#include "physmem.h"
+#include "traffic.h"
+#include "io.h"
+#include "swap.h"
+
+// 内核上下文：一次模拟的全部状态
+// 每个线程用kernel_ctx_bind()绑定一个上下文，内核API都作用于当前线程绑定的上下文；
+// 未绑定的线程使用默认上下文。上下文在使用前需调用kernel_init()
+typedef struct kernel_ctx_t {
+    partition_t parts[MAX_PARTITIONS];       // 分区表
+    uint32_t part_count;
+    partition_index_t part_index;            // 分区查找用的结构数组
+    uint32_t layout_sizes[MAX_PARTITIONS];   // partition_init()使用的布局
+    uint32_t layout_count;
+    process_t procs[MAX_PROCESSES];          // 进程表 (热数据)
+    process_info_t proc_info[MAX_PROCESSES]; // 进程冷数据，与procs同下标
+    uint32_t next_pid;
+    scheduler_t sched;                       // 调度器
+    allocation_strategy_t strategy;          // 当前分配策略
+    uint32_t current_time;
+    physmem_t mem;                           // 模拟物理内存 (mmap映射)
+    log_state_t log;
+    frag_state_t frag;
+    adapt_state_t adapt;
+    traffic_state_t traffic;
+    io_state_t io;                           // I/O设备
+    swap_state_t swap;                       // 交换
+} kernel_ctx_t;
+
+extern KERNEL_THREAD_LOCAL kernel_ctx_t* kernel_ctx_tls;
+
+static inline kernel_ctx_t* kernel_ctx_current(void) {
+    return kernel_ctx_tls;
+}
+
+// 进程的冷数据
+static inline process_info_t* process_info(const process_t* proc) {
+    kernel_ctx_t* ctx = kernel_ctx_current();
+    return &ctx->proc_info[proc - ctx->procs];
+}
+
+kernel_ctx_t* kernel_ctx_create(void);
+void kernel_ctx_destroy(kernel_ctx_t* ctx);
+kernel_ctx_t* kernel_ctx_bind(kernel_ctx_t* ctx);   // 返回之前绑定的上下文，NULL表示默认上下文
+
+// 内核全局状态，映射到当前上下文
+#define partition_table (kernel_ctx_current()->parts)
+#define partition_count (kernel_ctx_current()->part_count)
+#define partition_index (kernel_ctx_current()->part_index)
+#define process_table (kernel_ctx_current()->procs)
+#define process_info_table (kernel_ctx_current()->proc_info)
+#define g_scheduler (kernel_ctx_current()->sched)
+#define current_strategy (kernel_ctx_current()->strategy)
 
 // 内核初始化函数
 void kernel_init(void);
@@ -0,0 +1,498 @@
+#include "os_types.h"
+#include "kstring.h"
+
+// 这些函数替换了整个程序的libc同名函数，必须防止编译器把下面的循环
+// 识别成memcpy/memset调用，否则会递归调用自身
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC optimize ("no-tree-loop-distribute-patterns")
+#endif
+#if defined(__clang__)
+#define KSTRING_NO_BUILTIN __attribute__((no_builtin))
+#else
+#define KSTRING_NO_BUILTIN
+#endif
+#if defined(_MSC_VER)
+#pragma function(memcpy, memset, strlen)
+#endif
+
+// strlen按对齐的整字/整向量读取，会读到结尾之后 (不跨页，实际安全)，
+// 在AddressSanitizer下不检查这些读取
+#if defined(__clang__)
+#if __has_feature(address_sanitizer)
+#define KSTRING_NO_ASAN __attribute__((no_sanitize_address))
+#endif
+#elif defined(__SANITIZE_ADDRESS__)
+#define KSTRING_NO_ASAN __attribute__((no_sanitize_address))
+#endif
+#ifndef KSTRING_NO_ASAN
+#define KSTRING_NO_ASAN
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define KSTRING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define KSTRING_X86 0
+#endif
+
+#if defined(__GNUC__)
+#define KSTRING_TARGET_SSE2 __attribute__((target("sse2")))
+#define KSTRING_TARGET_AVX2 __attribute__((target("avx2")))
+typedef size_t __attribute__((__may_alias__)) kword_t;
+typedef size_t __attribute__((__may_alias__, __aligned__(1))) kword_unaligned_t;
+#else
+#define KSTRING_TARGET_SSE2
+#define KSTRING_TARGET_AVX2
+typedef size_t kword_t;
+typedef size_t kword_unaligned_t;
+#endif
+
+#define WORD_SIZE sizeof(size_t)
+#define WORD_ONES ((size_t)-1 / 0xFF)    // 0x0101...01
+#define WORD_HIGHS (WORD_ONES * 0x80)    // 0x8080...80
+#define WORD_HAS_ZERO(v) (((v) - WORD_ONES) & ~(v) & WORD_HIGHS)
+
+// ---------------------------------------------------------------
+// 逐字节实现 (原实现，保留用于基准对比)
+// ---------------------------------------------------------------
+
+static KSTRING_NO_BUILTIN void* memcpy_byte(void* dst, const void* src, size_t n) {
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+static KSTRING_NO_BUILTIN void* memset_byte(void* dst, int val, size_t n) {
+    uint8_t* d = (uint8_t*)dst;
+    while (n--) {
+        *d++ = (uint8_t)val;
+    }
+    return dst;
+}
+
+static KSTRING_NO_BUILTIN size_t strlen_byte(const char* str) {
+    const char* s = str;
+    while (*s) s++;
+    return (size_t)(s - str);
+}
+
+// ---------------------------------------------------------------
+// 按机器字实现 (可移植后备)
+// ---------------------------------------------------------------
+
+// 先按字节对齐目标地址，然后按字复制 (源地址可以不对齐)
+static KSTRING_NO_BUILTIN void* memcpy_word(void* dst, const void* src, size_t n) {
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    while (n && ((uintptr_t)d & (WORD_SIZE - 1))) {
+        *d++ = *s++;
+        n--;
+    }
+    while (n >= 4 * WORD_SIZE) {
+        ((kword_t*)d)[0] = ((const kword_unaligned_t*)s)[0];
+        ((kword_t*)d)[1] = ((const kword_unaligned_t*)s)[1];
+        ((kword_t*)d)[2] = ((const kword_unaligned_t*)s)[2];
+        ((kword_t*)d)[3] = ((const kword_unaligned_t*)s)[3];
+        d += 4 * WORD_SIZE;
+        s += 4 * WORD_SIZE;
+        n -= 4 * WORD_SIZE;
+    }
+    while (n >= WORD_SIZE) {
+        *(kword_t*)d = *(const kword_unaligned_t*)s;
+        d += WORD_SIZE;
+        s += WORD_SIZE;
+        n -= WORD_SIZE;
+    }
+    while (n--) {
+        *d++ = *s++;
+    }
+    return dst;
+}
+
+static KSTRING_NO_BUILTIN void* memset_word(void* dst, int val, size_t n) {
+    uint8_t* d = (uint8_t*)dst;
+    uint8_t b = (uint8_t)val;
+    size_t pattern = WORD_ONES * b;
+
+    while (n && ((uintptr_t)d & (WORD_SIZE - 1))) {
+        *d++ = b;
+        n--;
+    }
+    while (n >= 4 * WORD_SIZE) {
+        ((kword_t*)d)[0] = pattern;
+        ((kword_t*)d)[1] = pattern;
+        ((kword_t*)d)[2] = pattern;
+        ((kword_t*)d)[3] = pattern;
+        d += 4 * WORD_SIZE;
+        n -= 4 * WORD_SIZE;
+    }
+    while (n >= WORD_SIZE) {
+        *(kword_t*)d = pattern;
+        d += WORD_SIZE;
+        n -= WORD_SIZE;
+    }
+    while (n--) {
+        *d++ = b;
+    }
+    return dst;
+}
+
+// 对齐后每次检查一个字是否含0字节；对齐读取不会跨页
+static KSTRING_NO_BUILTIN KSTRING_NO_ASAN size_t strlen_word(const char* str) {
+    const char* s = str;
+
+    while ((uintptr_t)s & (WORD_SIZE - 1)) {
+        if (!*s) return (size_t)(s - str);
+        s++;
+    }
+
+    const kword_t* w = (const kword_t*)s;
+    while (!WORD_HAS_ZERO(*w)) {
+        w++;
+    }
+
+    s = (const char*)w;
+    while (*s) s++;
+    return (size_t)(s - str);
+}
+
+// ---------------------------------------------------------------
+// SSE2 / AVX2 实现
+// ---------------------------------------------------------------
+
+#if KSTRING_X86
+
+static unsigned kstring_ctz(unsigned mask) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (unsigned)idx;
+#else
+    return (unsigned)__builtin_ctz(mask);
+#endif
+}
+
+// 头部一次非对齐存储后把目标对齐到16字节，尾部用一次与前面重叠的非对齐存储
+static KSTRING_TARGET_SSE2 KSTRING_NO_BUILTIN void* memcpy_sse2(void* dst, const void* src, size_t n) {
+    if (n < 64) return memcpy_word(dst, src, n);
+
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* end_d = d + n;
+    const uint8_t* end_s = s + n;
+
+    size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+    _mm_storeu_si128((__m128i*)d, _mm_loadu_si128((const __m128i*)s));
+    d += head;
+    s += head;
+    n -= head;
+
+    while (n >= 64) {
+        __m128i a = _mm_loadu_si128((const __m128i*)(s + 0));
+        __m128i b = _mm_loadu_si128((const __m128i*)(s + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(s + 32));
+        __m128i e = _mm_loadu_si128((const __m128i*)(s + 48));
+        _mm_store_si128((__m128i*)(d + 0), a);
+        _mm_store_si128((__m128i*)(d + 16), b);
+        _mm_store_si128((__m128i*)(d + 32), c);
+        _mm_store_si128((__m128i*)(d + 48), e);
+        d += 64;
+        s += 64;
+        n -= 64;
+    }
+    while (n >= 16) {
+        _mm_store_si128((__m128i*)d, _mm_loadu_si128((const __m128i*)s));
+        d += 16;
+        s += 16;
+        n -= 16;
+    }
+    if (n) {
+        _mm_storeu_si128((__m128i*)(end_d - 16), _mm_loadu_si128((const __m128i*)(end_s - 16)));
+    }
+    return dst;
+}
+
+static KSTRING_TARGET_SSE2 KSTRING_NO_BUILTIN void* memset_sse2(void* dst, int val, size_t n) {
+    if (n < 64) return memset_word(dst, val, n);
+
+    uint8_t* d = (uint8_t*)dst;
+    uint8_t* end_d = d + n;
+    __m128i v = _mm_set1_epi8((char)val);
+
+    size_t head = (16 - ((uintptr_t)d & 15)) & 15;
+    _mm_storeu_si128((__m128i*)d, v);
+    d += head;
+    n -= head;
+
+    while (n >= 64) {
+        _mm_store_si128((__m128i*)(d + 0), v);
+        _mm_store_si128((__m128i*)(d + 16), v);
+        _mm_store_si128((__m128i*)(d + 32), v);
+        _mm_store_si128((__m128i*)(d + 48), v);
+        d += 64;
+        n -= 64;
+    }
+    while (n >= 16) {
+        _mm_store_si128((__m128i*)d, v);
+        d += 16;
+        n -= 16;
+    }
+    if (n) {
+        _mm_storeu_si128((__m128i*)(end_d - 16), v);
+    }
+    return dst;
+}
+
+// 从16字节对齐的地址开始比较，屏蔽掉字符串开头之前的字节
+static KSTRING_TARGET_SSE2 KSTRING_NO_BUILTIN KSTRING_NO_ASAN size_t strlen_sse2(const char* str) {
+    const char* p = (const char*)((uintptr_t)str & ~(uintptr_t)15);
+    __m128i zero = _mm_setzero_si128();
+    unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)p), zero));
+
+    mask &= 0xFFFFu << ((uintptr_t)str & 15);
+    while (!mask) {
+        p += 16;
+        mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)p), zero));
+    }
+    return (size_t)(p + kstring_ctz(mask) - str);
+}
+
+static KSTRING_TARGET_AVX2 KSTRING_NO_BUILTIN void* memcpy_avx2(void* dst, const void* src, size_t n) {
+    if (n < 256) return memcpy_sse2(dst, src, n);
+
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+    uint8_t* end_d = d + n;
+    const uint8_t* end_s = s + n;
+
+    size_t head = (32 - ((uintptr_t)d & 31)) & 31;
+    _mm256_storeu_si256((__m256i*)d, _mm256_loadu_si256((const __m256i*)s));
+    d += head;
+    s += head;
+    n -= head;
+
+    while (n >= 128) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(s + 0));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(s + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(s + 64));
+        __m256i e = _mm256_loadu_si256((const __m256i*)(s + 96));
+        _mm256_store_si256((__m256i*)(d + 0), a);
+        _mm256_store_si256((__m256i*)(d + 32), b);
+        _mm256_store_si256((__m256i*)(d + 64), c);
+        _mm256_store_si256((__m256i*)(d + 96), e);
+        d += 128;
+        s += 128;
+        n -= 128;
+    }
+    while (n >= 32) {
+        _mm256_store_si256((__m256i*)d, _mm256_loadu_si256((const __m256i*)s));
+        d += 32;
+        s += 32;
+        n -= 32;
+    }
+    if (n) {
+        _mm256_storeu_si256((__m256i*)(end_d - 32), _mm256_loadu_si256((const __m256i*)(end_s - 32)));
+    }
+    return dst;
+}
+
+static KSTRING_TARGET_AVX2 KSTRING_NO_BUILTIN void* memset_avx2(void* dst, int val, size_t n) {
+    if (n < 256) return memset_sse2(dst, val, n);
+
+    uint8_t* d = (uint8_t*)dst;
+    uint8_t* end_d = d + n;
+    __m256i v = _mm256_set1_epi8((char)val);
+
+    size_t head = (32 - ((uintptr_t)d & 31)) & 31;
+    _mm256_storeu_si256((__m256i*)d, v);
+    d += head;
+    n -= head;
+
+    while (n >= 128) {
+        _mm256_store_si256((__m256i*)(d + 0), v);
+        _mm256_store_si256((__m256i*)(d + 32), v);
+        _mm256_store_si256((__m256i*)(d + 64), v);
+        _mm256_store_si256((__m256i*)(d + 96), v);
+        d += 128;
+        n -= 128;
+    }
+    while (n >= 32) {
+        _mm256_store_si256((__m256i*)d, v);
+        d += 32;
+        n -= 32;
+    }
+    if (n) {
+        _mm256_storeu_si256((__m256i*)(end_d - 32), v);
+    }
+    return dst;
+}
+
+static KSTRING_TARGET_AVX2 KSTRING_NO_BUILTIN KSTRING_NO_ASAN size_t strlen_avx2(const char* str) {
+    const char* p = (const char*)((uintptr_t)str & ~(uintptr_t)31);
+    __m256i zero = _mm256_setzero_si256();
+    unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i*)p), zero));
+
+    mask &= 0xFFFFFFFFu << ((uintptr_t)str & 31);
+    while (!mask) {
+        p += 32;
+        mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256((const __m256i*)p), zero));
+    }
+    return (size_t)(p + kstring_ctz(mask) - str);
+}
+
+// CPU特性检测
+static BOOL cpu_has_sse2(void) {
+#if defined(_M_X64) || defined(__x86_64__)
+    return TRUE;  // x86-64必定支持SSE2
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] >> 26) & 1;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2") != 0;
+#endif
+}
+
+static BOOL cpu_has_avx2(void) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return FALSE;
+    __cpuid(info, 1);
+    // 需要OSXSAVE和AVX，并且操作系统保存了YMM状态
+    if (!((info[2] >> 27) & 1) || !((info[2] >> 28) & 1)) return FALSE;
+    if ((_xgetbv(0) & 6) != 6) return FALSE;
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+#else
+    // 可能在构造函数运行前就被libc调用，需要先初始化
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#else
+
+static BOOL cpu_has_sse2(void) { return FALSE; }
+static BOOL cpu_has_avx2(void) { return FALSE; }
+
+#endif // KSTRING_X86
+
+// ---------------------------------------------------------------
+// 运行期分派
+// ---------------------------------------------------------------
+
+static const kstring_ops_t kstring_ops[KSTRING_IMPL_COUNT] = {
+    { "byte", memcpy_byte, memset_byte, strlen_byte },
+    { "word", memcpy_word, memset_word, strlen_word },
+#if KSTRING_X86
+    { "sse2", memcpy_sse2, memset_sse2, strlen_sse2 },
+    { "avx2", memcpy_avx2, memset_avx2, strlen_avx2 },
+#else
+    { "sse2", NULL, NULL, NULL },
+    { "avx2", NULL, NULL, NULL },
+#endif
+};
+
+static void* memcpy_resolve(void* dst, const void* src, size_t n);
+static void* memset_resolve(void* dst, int val, size_t n);
+static size_t strlen_resolve(const char* str);
+
+// 初始指向解析函数，第一次调用时替换为最佳实现。
+// 多个线程可能同时首次调用并各自解析 (结果相同)，因此指针的读写都是原子的
+#if defined(_MSC_VER)
+#define KSTRING_SHARED volatile
+#define KSTRING_LOAD(var) (var)
+#define KSTRING_STORE(var, val) ((var) = (val))
+#else
+#define KSTRING_SHARED
+#define KSTRING_LOAD(var) __atomic_load_n(&(var), __ATOMIC_RELAXED)
+#define KSTRING_STORE(var, val) __atomic_store_n(&(var), (val), __ATOMIC_RELAXED)
+#endif
+
+static void* (* KSTRING_SHARED memcpy_impl)(void*, const void*, size_t) = memcpy_resolve;
+static void* (* KSTRING_SHARED memset_impl)(void*, int, size_t) = memset_resolve;
+static size_t (* KSTRING_SHARED strlen_impl)(const char*) = strlen_resolve;
+static KSTRING_SHARED kstring_impl_t active_impl = KSTRING_IMPL_WORD;
+
+const kstring_ops_t* kstring_get_ops(kstring_impl_t impl) {
+    if (impl >= KSTRING_IMPL_COUNT || !kstring_ops[impl].memcpy_fn) {
+        return NULL;
+    }
+    if (impl == KSTRING_IMPL_SSE2 && !cpu_has_sse2()) return NULL;
+    if (impl == KSTRING_IMPL_AVX2 && !cpu_has_avx2()) return NULL;
+    return &kstring_ops[impl];
+}
+
+int kstring_select_impl(kstring_impl_t impl) {
+    const kstring_ops_t* ops = kstring_get_ops(impl);
+    if (!ops) {
+        return -1;
+    }
+    KSTRING_STORE(active_impl, impl);
+    KSTRING_STORE(memcpy_impl, ops->memcpy_fn);
+    KSTRING_STORE(memset_impl, ops->memset_fn);
+    KSTRING_STORE(strlen_impl, ops->strlen_fn);
+    return 0;
+}
+
+static void kstring_resolve(void) {
+    if (kstring_select_impl(KSTRING_IMPL_AVX2) != 0 &&
+        kstring_select_impl(KSTRING_IMPL_SSE2) != 0) {
+        kstring_select_impl(KSTRING_IMPL_WORD);
+    }
+}
+
+kstring_impl_t kstring_active_impl(void) {
+    if (KSTRING_LOAD(memcpy_impl) == memcpy_resolve) {
+        kstring_resolve();
+    }
+    return KSTRING_LOAD(active_impl);
+}
+
+static void* memcpy_resolve(void* dst, const void* src, size_t n) {
+    kstring_resolve();
+    return KSTRING_LOAD(memcpy_impl)(dst, src, n);
+}
+
+static void* memset_resolve(void* dst, int val, size_t n) {
+    kstring_resolve();
+    return KSTRING_LOAD(memset_impl)(dst, val, n);
+}
+
+static size_t strlen_resolve(const char* str) {
+    kstring_resolve();
+    return KSTRING_LOAD(strlen_impl)(str);
+}
+
+// ---------------------------------------------------------------
+// 对外接口 (替换libc同名函数)
+// ---------------------------------------------------------------
+
+// 内存复制
+void* memcpy(void* dst, const void* src, size_t n) {
+    return KSTRING_LOAD(memcpy_impl)(dst, src, n);
+}
+
+// 内存设置
+void* memset(void* dst, int val, size_t n) {
+    return KSTRING_LOAD(memset_impl)(dst, val, n);
+}
+
+// 字符串长度
+size_t strlen(const char* str) {
+    return KSTRING_LOAD(strlen_impl)(str);
+}
+
+// 字符串复制
+char* strcpy(char* dest, const char* src) {
+    return (char*)memcpy(dest, src, strlen(src) + 1);
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#ifndef _KSTRING_H
+#define _KSTRING_H
+
+#include "os_types.h"
+
+// 内核字符串/内存函数实现
+// memcpy/memset/strlen 由 kstring.c 提供 (声明见os_types.h)，
+// 首次调用时按CPU特性选择实现，之后通过函数指针直接调用
+typedef enum {
+    KSTRING_IMPL_BYTE,   // 逐字节 (原实现，仅用于对比)
+    KSTRING_IMPL_WORD,   // 按机器字 (可移植后备实现)
+    KSTRING_IMPL_SSE2,   // SSE2 16字节块
+    KSTRING_IMPL_AVX2,   // AVX2 32字节块
+    KSTRING_IMPL_COUNT
+} kstring_impl_t;
+
+// 一组实现
+typedef struct kstring_ops_t {
+    const char* name;
+    void* (*memcpy_fn)(void* dst, const void* src, size_t n);
+    void* (*memset_fn)(void* dst, int val, size_t n);
+    size_t (*strlen_fn)(const char* str);
+} kstring_ops_t;
+
+// 获取指定实现，当前CPU或编译器不支持时返回NULL
+const kstring_ops_t* kstring_get_ops(kstring_impl_t impl);
+
+// 当前memcpy/memset/strlen实际使用的实现
+kstring_impl_t kstring_active_impl(void);
+
+// 强制使用指定实现 (不支持时返回-1)
+int kstring_select_impl(kstring_impl_t impl);
+
+#endif // _KSTRING_H
\ No newline at end of file
@@ -0,0 +1,408 @@
+// 分区布局优化器：根据工作负载轨迹搜索分区大小组合，使内部浪费和准入等待最小
+// 模拟退火，每一步的候选布局由多个工作进程并行模拟 (fork + 管道，仅POSIX)
+// 编译: gcc -O2 -o layout_opt layout_opt.c sim.c init.c log.c kstring.c perf.c frag.c adapt.c physmem.c traffic.c io.c swap.c process.c partition.c memory.c scheduler.c compact.c snapshot.c
+// 运行: ./layout_opt [--trace FILE | --count N --seed S] [--budget B] [--workers W] [--iters I]
+//                    [--waste-weight X] [--strategy first|best|worst] [--scheduler fifo|rr|priority|edf] [--out FILE]
+// 输出文件可直接传给 kernel_simulator 或 partition_load_layout()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sim.h"
+#include "config.h"
+
+#define GRANULARITY 8            // 分区大小取8的倍数
+#define NEIGHBOR_TRIES 1000      // 随机邻域的尝试次数，都不可行时保持原布局
+#define UNSERVED_PENALTY 1000.0  // 未完成/被拒绝的进程折算成的等待时间
+#define MAX_WORKERS 16
+#define MAX_LAYOUT (MAX_PARTITIONS - 1)
+
+typedef struct layout_t {
+    uint32_t count;
+    uint32_t sizes[MAX_LAYOUT];
+} layout_t;
+
+// 一次模拟的评价结果
+typedef struct eval_t {
+    double cost;
+    double admit_delay;   // 平均准入等待
+    double waste;         // 每次分配的平均内部浪费
+    double unserved;      // 被拒绝或未完成的比例
+} eval_t;
+
+typedef struct worker_t {
+    pid_t pid;
+    int req_fd;           // 父 -> 子: layout_t
+    int resp_fd;          // 子 -> 父: eval_t
+} worker_t;
+
+static trace_t trace;
+static sim_config_t config;
+static uint32_t budget = MEMORY_SIZE - OS_PARTITION_SIZE;
+static double waste_weight = 0.05;
+static uint32_t rng_state = 12345;
+
+static uint32_t rng_next(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return rng_state = x;
+}
+
+static uint32_t rng_range(uint32_t lo, uint32_t hi) {
+    return hi > lo ? lo + rng_next() % (hi - lo + 1) : lo;
+}
+
+static uint32_t layout_total(const layout_t* l) {
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < l->count; i++) total += l->sizes[i];
+    return total;
+}
+
+static int cmp_desc(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x < y) - (x > y);
+}
+
+static uint32_t round_up(uint32_t v) {
+    v = (v + GRANULARITY - 1) / GRANULARITY * GRANULARITY;
+    return v < MIN_PARTITION_SIZE ? MIN_PARTITION_SIZE : v;
+}
+
+// 在给定布局上运行整条轨迹
+static eval_t evaluate(const layout_t* l) {
+    eval_t e;
+    sim_result_t r;
+
+    memset(&e, 0, sizeof(e));
+    if (partition_set_layout(l->sizes, l->count) != 0 || sim_run(&trace, &config, &r) != 0) {
+        e.cost = 1e18;
+        return e;
+    }
+    e.admit_delay = r.avg_admit_delay;
+    e.waste = r.avg_alloc_waste;
+    e.unserved = trace.count ? (double)(r.rejected + r.unfinished) / trace.count : 0;
+    e.cost = e.admit_delay + waste_weight * e.waste + UNSERVED_PENALTY * e.unserved;
+    sim_result_free(&r);
+    return e;
+}
+
+static int read_full(int fd, void* buf, size_t n) {
+    char* p = (char*)buf;
+    while (n) {
+        ssize_t got = read(fd, p, n);
+        if (got <= 0) return -1;
+        p += got;
+        n -= (size_t)got;
+    }
+    return 0;
+}
+
+static int write_full(int fd, const void* buf, size_t n) {
+    const char* p = (const char*)buf;
+    while (n) {
+        ssize_t put = write(fd, p, n);
+        if (put <= 0) return -1;
+        p += put;
+        n -= (size_t)put;
+    }
+    return 0;
+}
+
+// 工作进程: 读布局、模拟、回写结果，直到管道关闭
+static void worker_loop(int req_fd, int resp_fd) {
+    layout_t l;
+    while (read_full(req_fd, &l, sizeof(l)) == 0) {
+        eval_t e = evaluate(&l);
+        if (write_full(resp_fd, &e, sizeof(e)) != 0) break;
+    }
+    _exit(0);
+}
+
+static int start_workers(worker_t* workers, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        int req[2], resp[2];
+        if (pipe(req) != 0 || pipe(resp) != 0) return -1;
+
+        pid_t pid = fork();
+        if (pid < 0) return -1;
+        if (pid == 0) {
+            // 关闭之前创建的工作进程的管道
+            for (uint32_t j = 0; j < i; j++) {
+                close(workers[j].req_fd);
+                close(workers[j].resp_fd);
+            }
+            close(req[1]);
+            close(resp[0]);
+            worker_loop(req[0], resp[1]);
+        }
+        close(req[0]);
+        close(resp[1]);
+        workers[i].pid = pid;
+        workers[i].req_fd = req[1];
+        workers[i].resp_fd = resp[0];
+    }
+    return 0;
+}
+
+static void stop_workers(worker_t* workers, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        close(workers[i].req_fd);
+        close(workers[i].resp_fd);
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        waitpid(workers[i].pid, NULL, 0);
+    }
+}
+
+// 并行评价n个候选布局
+static int evaluate_batch(worker_t* workers, const layout_t* cand, eval_t* out, uint32_t n) {
+    for (uint32_t i = 0; i < n; i++) {
+        if (write_full(workers[i].req_fd, &cand[i], sizeof(layout_t)) != 0) return -1;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+        if (read_full(workers[i].resp_fd, &out[i], sizeof(eval_t)) != 0) return -1;
+    }
+    return 0;
+}
+
+// 随机邻域: 调整大小、在分区间转移、拆分、合并、增加或删除一个分区；
+// 没有可行的移动 (如只有一个不能再变的分区) 时返回原布局
+static void neighbor(const layout_t* from, layout_t* to) {
+    for (uint32_t tries = 0; tries < NEIGHBOR_TRIES; tries++) {
+        *to = *from;
+        uint32_t total = layout_total(to);
+        uint32_t free_bytes = total < budget ? budget - total : 0;
+        uint32_t i = rng_range(0, to->count - 1);
+        uint32_t j = rng_range(0, to->count - 1);
+        uint32_t delta = GRANULARITY * rng_range(1, 4);
+
+        switch (rng_range(0, 5)) {
+            case 0:   // 变大
+                if (delta > free_bytes) continue;
+                to->sizes[i] += delta;
+                break;
+            case 1:   // 变小
+                if (to->sizes[i] < MIN_PARTITION_SIZE + delta) continue;
+                to->sizes[i] -= delta;
+                break;
+            case 2:   // 转移
+                if (i == j || to->sizes[i] < MIN_PARTITION_SIZE + delta) continue;
+                to->sizes[i] -= delta;
+                to->sizes[j] += delta;
+                break;
+            case 3: { // 拆分
+                if (to->count == MAX_LAYOUT || to->sizes[i] < 2 * MIN_PARTITION_SIZE) continue;
+                uint32_t part = rng_range(MIN_PARTITION_SIZE, to->sizes[i] - MIN_PARTITION_SIZE) / GRANULARITY * GRANULARITY;
+                to->sizes[to->count++] = to->sizes[i] - part;
+                to->sizes[i] = part;
+                break;
+            }
+            case 4:   // 合并
+                if (i == j) continue;
+                to->sizes[i] += to->sizes[j];
+                to->sizes[j] = to->sizes[--to->count];
+                break;
+            default:  // 增加或删除
+                if (free_bytes >= MIN_PARTITION_SIZE && to->count < MAX_LAYOUT && rng_range(0, 1)) {
+                    to->sizes[to->count++] = rng_range(MIN_PARTITION_SIZE, free_bytes) / GRANULARITY * GRANULARITY;
+                } else {
+                    if (to->count == 1) continue;
+                    to->sizes[i] = to->sizes[--to->count];
+                }
+                break;
+        }
+        qsort(to->sizes, to->count, sizeof(uint32_t), cmp_desc);
+        if (layout_total(to) <= budget) return;
+    }
+    *to = *from;
+}
+
+// 初始布局: 按内存需求分布的分位数取 n 个分区大小，最大分区覆盖最大需求；
+// 单个分区不超过预算，因此至少一个分区的布局总在预算内
+static void quantile_layout(layout_t* l, uint32_t n) {
+    uint32_t* req = (uint32_t*)malloc(sizeof(uint32_t) * trace.count);
+    uint32_t cap = budget / GRANULARITY * GRANULARITY;
+    for (uint32_t i = 0; i < trace.count; i++) req[i] = trace.entries[i].memory_size;
+    qsort(req, trace.count, sizeof(uint32_t), cmp_desc);
+
+    for (; n >= 1; n--) {
+        l->count = n;
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t size = round_up(req[(uint64_t)trace.count * i / n]);
+            l->sizes[i] = size < cap ? size : cap;
+        }
+        if (layout_total(l) <= budget) break;
+    }
+    free(req);
+}
+
+static void print_layout(FILE* f, const layout_t* l) {
+    for (uint32_t i = 0; i < l->count; i++) {
+        fprintf(f, "%s%u", i ? " " : "", l->sizes[i]);
+    }
+    fprintf(f, "\n");
+}
+
+static void print_eval(const char* label, const layout_t* l, const eval_t* e) {
+    printf("%-9s cost %9.2f  admit %7.2f  waste %6.1f B  unserved %5.1f%%  [%u B] ", label, e->cost,
+        e->admit_delay, e->waste, e->unserved * 100, layout_total(l));
+    print_layout(stdout, l);
+}
+
+int main(int argc, char** argv) {
+    trace_params_t params;
+    const char* trace_path = NULL;
+    const char* out_path = NULL;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t nworkers = cpus > 0 ? (uint32_t)cpus : 1;
+    uint32_t iters = 200;
+
+    trace_default_params(&params);
+    config.strategy = BEST_FIT;
+    config.scheduler = SCHED_RR;
+    config.max_ticks = 0;
+    config.sample_interval = 1000;
+    config.adaptive = 0;
+    config.traffic = TRAFFIC_NONE;
+    config.io_service_time = 0;
+    config.io_sched = IO_SCHED_FIFO;
+    config.swap = 0;
+    config.reclaim = RECLAIM_PRIORITY;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!v) { fprintf(stderr, "missing value for %s\n", a); return 1; }
+        if (strcmp(a, "--trace") == 0) trace_path = v;
+        else if (strcmp(a, "--count") == 0) params.count = (uint32_t)atoi(v);
+        else if (strcmp(a, "--seed") == 0) params.seed = (uint32_t)atoi(v);
+        else if (strcmp(a, "--budget") == 0) budget = (uint32_t)atoi(v);
+        else if (strcmp(a, "--workers") == 0) nworkers = (uint32_t)atoi(v);
+        else if (strcmp(a, "--iters") == 0) iters = (uint32_t)atoi(v);
+        else if (strcmp(a, "--waste-weight") == 0) waste_weight = atof(v);
+        else if (strcmp(a, "--out") == 0) out_path = v;
+        else if (strcmp(a, "--strategy") == 0) {
+            config.strategy = v[0] == 'f' ? FIRST_FIT : v[0] == 'w' ? WORST_FIT : BEST_FIT;
+        } else if (strcmp(a, "--scheduler") == 0) {
+            config.scheduler = v[0] == 'f' ? SCHED_FIFO : v[0] == 'p' ? SCHED_PRIORITY :
+                v[0] == 'e' ? SCHED_EDF : SCHED_RR;
+        } else { fprintf(stderr, "unknown option %s\n", a); return 1; }
+        i++;
+    }
+    if (nworkers < 1) nworkers = 1;
+    if (nworkers > MAX_WORKERS) nworkers = MAX_WORKERS;
+    if (budget > MEMORY_SIZE - OS_PARTITION_SIZE) budget = MEMORY_SIZE - OS_PARTITION_SIZE;
+    if (budget < MIN_PARTITION_SIZE) {
+        fprintf(stderr, "budget must be at least %u bytes\n", (unsigned)MIN_PARTITION_SIZE);
+        return 1;
+    }
+
+    if (trace_path ? trace_load(&trace, trace_path) : trace_generate(&trace, &params)) {
+        fprintf(stderr, "failed to %s trace\n", trace_path ? "load" : "generate");
+        return 1;
+    }
+    if (trace.count == 0) {
+        fprintf(stderr, "empty trace\n");
+        return 1;
+    }
+    uint64_t total = trace.entries[trace.count - 1].arrival_time;
+    for (uint32_t i = 0; i < trace.count; i++) {
+        total += trace.entries[i].burst_time + (uint64_t)trace.entries[i].io_requests *
+            (IO_SERVICE_TIME + (DISK_TRACKS + DISK_SEEK_SPEED - 1) / DISK_SEEK_SPEED);
+    }
+    config.max_ticks = (uint32_t)(total + 1000 < 0xFFFFFFF0u ? total + 1000 : 0xFFFFFFF0u);
+
+    // 基准: 预定义布局
+    layout_t base;
+    partition_set_layout(NULL, 0);
+    base.count = partition_get_layout(base.sizes, MAX_LAYOUT);
+    eval_t base_eval = evaluate(&base);
+
+    // 并发度 (Little定律: 到达率 x 平均周转时间) 决定初始分区个数
+    sim_result_t r;
+    partition_set_layout(base.sizes, base.count);
+    sim_run(&trace, &config, &r);
+    double rate = (double)trace.count / (trace.entries[trace.count - 1].arrival_time + 1);
+    uint32_t concurrency = (uint32_t)(rate * r.avg_turnaround + 0.5);
+    sim_result_free(&r);
+    if (concurrency < 1) concurrency = 1;
+    if (concurrency > MAX_LAYOUT) concurrency = MAX_LAYOUT;
+
+    layout_t seed;
+    quantile_layout(&seed, concurrency);
+    eval_t seed_eval = evaluate(&seed);
+
+    printf("trace: %u processes, budget %u bytes, %s/%s, concurrency ~%u, %u workers\n", trace.count, budget,
+        sim_strategy_name(config.strategy), sim_scheduler_name(config.scheduler), concurrency, nworkers);
+    print_eval("default", &base, &base_eval);
+    print_eval("quantile", &seed, &seed_eval);
+
+    worker_t workers[MAX_WORKERS];
+    if (start_workers(workers, nworkers) != 0) {
+        fprintf(stderr, "failed to start workers\n");
+        return 1;
+    }
+
+    // 超出预算的预定义布局只作对比，不作为起点
+    int from_base = layout_total(&base) <= budget && base_eval.cost < seed_eval.cost;
+    layout_t cur = from_base ? base : seed;
+    eval_t cur_eval = from_base ? base_eval : seed_eval;
+    layout_t best = cur;
+    eval_t best_eval = cur_eval;
+    double t0 = cur_eval.cost * 0.05 + 1.0;
+    layout_t cand[MAX_WORKERS];
+    eval_t cand_eval[MAX_WORKERS];
+
+    for (uint32_t it = 0; it < iters; it++) {
+        double temp = t0 * pow(1e-3, (double)it / iters);
+
+        for (uint32_t w = 0; w < nworkers; w++) neighbor(&cur, &cand[w]);
+        if (evaluate_batch(workers, cand, cand_eval, nworkers) != 0) {
+            fprintf(stderr, "worker failed\n");
+            break;
+        }
+
+        uint32_t pick = 0;
+        for (uint32_t w = 1; w < nworkers; w++) {
+            if (cand_eval[w].cost < cand_eval[pick].cost) pick = w;
+        }
+        double d = cand_eval[pick].cost - cur_eval.cost;
+        if (d <= 0 || (double)rng_next() / 4294967296.0 < exp(-d / temp)) {
+            cur = cand[pick];
+            cur_eval = cand_eval[pick];
+        }
+        if (cur_eval.cost < best_eval.cost) {
+            best = cur;
+            best_eval = cur_eval;
+        }
+        if ((it + 1) % (iters / 10 ? iters / 10 : 1) == 0) {
+            char label[16];
+            snprintf(label, sizeof(label), "it %u", it + 1);
+            print_eval(label, &best, &best_eval);
+        }
+    }
+    stop_workers(workers, nworkers);
+
+    print_eval("best", &best, &best_eval);
+    if (out_path) {
+        FILE* f = fopen(out_path, "w");
+        if (!f) {
+            fprintf(stderr, "failed to write %s\n", out_path);
+            return 1;
+        }
+        fprintf(f, "# partition layout: %u partitions, %u of %u bytes (%s/%s, %u processes)\n",
+            best.count, layout_total(&best), budget, sim_strategy_name(config.strategy),
+            sim_scheduler_name(config.scheduler), trace.count);
+        fprintf(f, "# admit delay %.2f, waste %.1f bytes/alloc, unserved %.1f%%\n",
+            best_eval.admit_delay, best_eval.waste, best_eval.unserved * 100);
+        print_layout(f, &best);
+        fclose(f);
+    }
+    trace_free(&trace);
+    return 0;
+}
@@ -1,159 +1,316 @@
 #include "os_types.h"
 #include "log.h"
 #include "config.h"
+#include "perf.h"
+#include "kernel.h"
 #include <stdarg.h>
 
-static char log_buffer[LOG_BUFFER_SIZE];
-static uint32_t log_buffer_pos = 0;
+#define LOG_LINE_SIZE 256
 
-// 򵥵ڴ渴
-void* memcpy(void* dst, const void* src, size_t n) {
-    uint8_t* d = (uint8_t*)dst;
-    const uint8_t* s = (const uint8_t*)src;
-    while (n--) {
-        *d++ = *s++;
+// ʽ˵
+typedef struct fmt_spec_t {
+    char conv;        // תַ
+    uint8_t left;     // '-' 
+    uint8_t zero;     // '0' 
+    uint8_t is_long;  // 'l' 
+    int width;        // С
+    int precision;    //  (-1ʾδָ)
+} fmt_spec_t;
+
+// ʽλ
+typedef struct fmt_out_t {
+    char* buf;
+    uint32_t size;
+    uint32_t pos;
+} fmt_out_t;
+
+// ־״̬λڵǰں
+#define log_buffer (kernel_ctx_current()->log.log_buffer)
+#define log_buffer_pos (kernel_ctx_current()->log.log_buffer_pos)
+#define log_records (kernel_ctx_current()->log.log_records)
+#define log_record_head (kernel_ctx_current()->log.log_record_head)
+#define log_record_count (kernel_ctx_current()->log.log_record_count)
+
+// ʽ˵pָ'%'֮󣬷˵֮λ
+static const char* parse_spec(const char* p, fmt_spec_t* spec) {
+    spec->left = 0;
+    spec->zero = 0;
+    spec->is_long = 0;
+    spec->width = 0;
+    spec->precision = -1;
+
+    while (*p == '-' || *p == '0') {
+        if (*p == '-') spec->left = 1;
+        else spec->zero = 1;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9') {
+        spec->width = spec->width * 10 + (*p++ - '0');
+    }
+    if (*p == '.') {
+        p++;
+        spec->precision = 0;
+        while (*p >= '0' && *p <= '9') {
+            spec->precision = spec->precision * 10 + (*p++ - '0');
+        }
     }
-    return dst;
+    while (*p == 'l' || *p == 'z') {
+        spec->is_long = 1;
+        p++;
+    }
+    spec->conv = *p;
+    return *p ? p + 1 : p;
 }
 
-// 򵥵ڴ
-void* memset(void* dst, int val, size_t n) {
-    uint8_t* d = (uint8_t*)dst;
-    while (n--) {
-        *d++ = (uint8_t)val;
+// ʽȡ (ʽ)strsǿʱ%sݸƽȥ
+static uint32_t capture_args(const char* fmt, va_list args, log_arg_t* out,
+    char* strs, uint32_t strs_size) {
+    uint32_t argc = 0;
+    uint32_t str_used = 0;
+    fmt_spec_t spec;
+
+    while (*fmt && argc < LOG_MAX_ARGS) {
+        if (*fmt++ != '%') continue;
+        fmt = parse_spec(fmt, &spec);
+
+        switch (spec.conv) {
+            case 'd': case 'i': case 'c':
+                out[argc++].i = spec.is_long ? (int64_t)va_arg(args, long) : va_arg(args, int);
+                break;
+            case 'u': case 'x': case 'X':
+                out[argc++].u = spec.is_long ? (uint64_t)va_arg(args, unsigned long)
+                                             : va_arg(args, unsigned int);
+                break;
+            case 'f':
+                out[argc++].f = va_arg(args, double);
+                break;
+            case 's': {
+                const char* str = va_arg(args, const char*);
+                if (!str) str = "(null)";
+                if (strs && str_used >= strs_size) {
+                    // ַ꣬Ϊ
+                    str = "";
+                } else if (strs) {
+                    // ַʽʱԭʧЧ
+                    char* dst = strs + str_used;
+                    while (*str && str_used + 1 < strs_size) {
+                        strs[str_used++] = *str++;
+                    }
+                    if (str_used < strs_size) strs[str_used++] = '\0';
+                    else strs[strs_size - 1] = '\0';
+                    str = dst;
+                }
+                out[argc++].s = str;
+                break;
+            }
+            default:
+                break;
+        }
     }
-    return dst;
+
+    return argc;
 }
 
-// ַ
-size_t strlen(const char* str) {
-    const char* s = str;
-    while (*s) s++;
-    return (size_t)(s - str);
+static void out_char(fmt_out_t* out, char c) {
+    if (out->pos + 1 < out->size) {
+        out->buf[out->pos++] = c;
+    }
 }
 
-// ַ
-char* strcpy(char* dest, const char* src) {
-    char* d = dest;
-    while ((*d++ = *src++));
-    return dest;
+static void out_pad(fmt_out_t* out, char c, int count) {
+    while (count-- > 0) {
+        out_char(out, c);
+    }
 }
 
-// תַ
-static char* itoa(int num, char* str, int base) {
-    char* ptr = str;
-    char* ptr1 = str;
-    char tmp_char;
-    int tmp_value;
-    int neg = 0;
+// һֶΣȡͲ
+static void out_field(fmt_out_t* out, const fmt_spec_t* spec, char sign,
+    const char* digits, int len, int numeric) {
+    int total = len + (sign ? 1 : 0);
+    int pad = spec->width > total ? spec->width - total : 0;
 
-    if (num == 0) {
-        *ptr++ = '0';
-        *ptr = '\0';
-        return str;
+    if (!spec->left && !(spec->zero && numeric)) out_pad(out, ' ', pad);
+    if (sign) out_char(out, sign);
+    if (!spec->left && spec->zero && numeric) out_pad(out, '0', pad);
+    for (int i = 0; i < len; i++) {
+        out_char(out, digits[i]);
     }
+    if (spec->left) out_pad(out, ' ', pad);
+}
 
-    if (num < 0 && base == 10) {
-        neg = 1;
-        num = -num;
-    }
+// ޷תַس
+static int utoa(uint64_t num, unsigned base, int upper, char* str) {
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char tmp[24];
+    int len = 0;
 
-    while (num) {
-        tmp_value = num % base;
-        if (tmp_value < 10)
-            tmp_char = '0' + tmp_value;
-        else
-            tmp_char = 'A' + (tmp_value - 10);
-        *ptr++ = tmp_char;
+    do {
+        tmp[len++] = digits[num % base];
         num /= base;
+    } while (num);
+
+    for (int i = 0; i < len; i++) {
+        str[i] = tmp[len - 1 - i];
     }
+    return len;
+}
+
+// תַ (ʽ)س
+static int ftoa(double num, int precision, char* str) {
+    static const uint64_t pow10[] = {
+        1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+    uint64_t int_part, frac_part;
+    int len;
 
-    if (neg) {
-        *ptr++ = '-';
+    if (num != num) {
+        str[0] = 'n'; str[1] = 'a'; str[2] = 'n';
+        return 3;
+    }
+    if (num >= 1.8e19) {
+        str[0] = 'i'; str[1] = 'n'; str[2] = 'f';
+        return 3;
     }
-    *ptr-- = '\0';
+    if (precision > 9) precision = 9;
 
-    while (ptr1 < ptr) {
-        tmp_char = *ptr1;
-        *ptr1++ = *ptr;
-        *ptr-- = tmp_char;
+    int_part = (uint64_t)num;
+    frac_part = (uint64_t)((num - (double)int_part) * pow10[precision] + 0.5);
+    if (frac_part >= pow10[precision]) {
+        int_part++;
+        frac_part -= pow10[precision];
     }
 
-    return str;
+    len = utoa(int_part, 10, 0, str);
+    if (precision > 0) {
+        char frac[24];
+        int frac_len = utoa(frac_part, 10, 0, frac);
+        str[len++] = '.';
+        for (int i = frac_len; i < precision; i++) {
+            str[len++] = '0';
+        }
+        for (int i = 0; i < frac_len; i++) {
+            str[len++] = frac[i];
+        }
+    }
+    return len;
 }
 
-// ں־ʼ
-void kernel_log_init(void) {
-    log_buffer_pos = 0;
-    memset(log_buffer, 0, LOG_BUFFER_SIZE);
+// ѶȡĲʽд볤
+static uint32_t format_args(char* buf, uint32_t size, const char* fmt,
+    const log_arg_t* args, uint32_t argc) {
+    fmt_out_t out = { buf, size, 0 };
+    fmt_spec_t spec;
+    uint32_t arg_idx = 0;
+    char num_str[48];
+
+    if (size == 0) return 0;
+
+    while (*fmt) {
+        if (*fmt != '%') {
+            out_char(&out, *fmt++);
+            continue;
+        }
+        fmt = parse_spec(fmt + 1, &spec);
+
+        if (spec.conv == '%') {
+            out_char(&out, '%');
+            continue;
+        }
+        if (spec.conv == '\0') break;
+
+        const char* valid = "diucxXsf";
+        while (*valid && *valid != spec.conv) valid++;
+        if (!*valid) {
+            // ֵ֧˵ԭ
+            out_char(&out, '%');
+            out_char(&out, spec.conv);
+            continue;
+        }
+        if (arg_idx >= argc) {
+            out_char(&out, '?');
+            continue;
+        }
+
+        const log_arg_t* arg = &args[arg_idx++];
+        switch (spec.conv) {
+            case 'd':
+            case 'i': {
+                int64_t v = arg->i;
+                uint64_t mag = v < 0 ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+                int len = utoa(mag, 10, 0, num_str);
+                out_field(&out, &spec, v < 0 ? '-' : 0, num_str, len, 1);
+                break;
+            }
+            case 'u': {
+                int len = utoa(arg->u, 10, 0, num_str);
+                out_field(&out, &spec, 0, num_str, len, 1);
+                break;
+            }
+            case 'x':
+            case 'X': {
+                int len = utoa(arg->u, 16, spec.conv == 'X', num_str);
+                out_field(&out, &spec, 0, num_str, len, 1);
+                break;
+            }
+            case 'c':
+                num_str[0] = (char)arg->i;
+                out_field(&out, &spec, 0, num_str, 1, 0);
+                break;
+            case 's': {
+                int len = 0;
+                while (arg->s[len] && (spec.precision < 0 || len < spec.precision)) len++;
+                out_field(&out, &spec, 0, arg->s, len, 0);
+                break;
+            }
+            case 'f': {
+                double v = arg->f;
+                int len = ftoa(v < 0 ? -v : v, spec.precision < 0 ? 6 : spec.precision, num_str);
+                out_field(&out, &spec, v < 0 ? '-' : 0, num_str, len, 1);
+                break;
+            }
+        }
+    }
+
+    buf[out.pos] = '\0';
+    return out.pos;
+}
+
+// ں˸ʽ
+int kernel_vsnprintf(char* buf, uint32_t size, const char* fmt, va_list args) {
+    log_arg_t argv[LOG_MAX_ARGS];
+    uint32_t argc = capture_args(fmt, args, argv, NULL, 0);
+    return (int)format_args(buf, size, fmt, argv, argc);
 }
 
-// ں־ (򻯰)
-void kernel_log(log_level_t level, const char* fmt, ...) {
+int kernel_snprintf(char* buf, uint32_t size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int len = kernel_vsnprintf(buf, size, fmt, args);
+    va_end(args);
+    return len;
+}
+
+// ʽһ¼д־
+static void log_drain_one(void) {
     static const char* level_str[] = {
         "EMERG", "ALERT", "CRIT", "ERR", "WARN", "NOTE", "INFO", "DEBUG"
     };
 
-    if (level > KERNEL_LOG_LEVEL) return;
-
-    // ־
-    char log_line[256];
+    log_record_t* rec = &log_records[log_record_head];
+    char log_line[LOG_LINE_SIZE];
     uint32_t pos = 0;
 
     // Ӽ
     log_line[pos++] = '[';
-    const char* lvl = level_str[level];
-    while (*lvl && pos < 250) {
+    const char* lvl = level_str[rec->level];
+    while (*lvl) {
         log_line[pos++] = *lvl++;
     }
     log_line[pos++] = ']';
     log_line[pos++] = ' ';
 
-    // ʽַ
-    va_list args;
-    va_start(args, fmt);
-
-    uint32_t fmt_pos = 0;
-    while (fmt[fmt_pos] && pos < 250) {
-        if (fmt[fmt_pos] == '%' && fmt[fmt_pos + 1]) {
-            fmt_pos++;
-            if (fmt[fmt_pos] == 'd') {
-                int num = va_arg(args, int);
-                char num_str[12];
-                itoa(num, num_str, 10);
-                char* p = num_str;
-                while (*p && pos < 250) {
-                    log_line[pos++] = *p++;
-                }
-            }
-            else if (fmt[fmt_pos] == 's') {
-                const char* str = va_arg(args, const char*);
-                while (*str && pos < 250) {
-                    log_line[pos++] = *str++;
-                }
-            }
-            else if (fmt[fmt_pos] == 'x') {
-                unsigned int num = va_arg(args, unsigned int);
-                char num_str[12];
-                itoa(num, num_str, 16);
-                char* p = num_str;
-                while (*p && pos < 250) {
-                    log_line[pos++] = *p++;
-                }
-            }
-            else {
-                log_line[pos++] = '%';
-                log_line[pos++] = fmt[fmt_pos];
-            }
-        }
-        else {
-            log_line[pos++] = fmt[fmt_pos];
-        }
-        fmt_pos++;
-    }
-
-    va_end(args);
-
+    // ʽϢзλ
+    pos += format_args(log_line + pos, LOG_LINE_SIZE - pos - 1, rec->fmt, rec->args, rec->argc);
     log_line[pos++] = '\n';
     log_line[pos] = '\0';
 
@@ -162,11 +319,62 @@ void kernel_log(log_level_t level, const char* fmt, ...) {
         memcpy(log_buffer + log_buffer_pos, log_line, pos);
         log_buffer_pos += pos;
     }
+
+    log_record_head = (log_record_head + 1) % LOG_RECORD_COUNT;
+    log_record_count--;
+}
+
+// ں־ʼ
+void kernel_log_init(void) {
+    log_buffer_pos = 0;
+    log_record_head = 0;
+    log_record_count = 0;
+    memset(log_buffer, 0, LOG_BUFFER_SIZE);
+}
+
+// ں־ֻ¼fmtָԭʼʽƳٵˢʱ
+void kernel_log_write(log_level_t level, const char* fmt, ...) {
+    // ڼļ (kernel_logڱڹ)
+    if (level > KERNEL_LOG_LEVEL) return;
+
+    PERF_BEGIN();
+
+    // ¼ʱȸʽļ¼
+    if (log_record_count == LOG_RECORD_COUNT) {
+        log_drain_one();
+    }
+
+    log_record_t* rec = &log_records[(log_record_head + log_record_count) % LOG_RECORD_COUNT];
+    rec->fmt = fmt;
+    rec->level = (uint8_t)level;
+
+    va_list args;
+    va_start(args, fmt);
+    rec->argc = (uint8_t)capture_args(fmt, args, rec->args, rec->strs, LOG_RECORD_STR_SIZE);
+    va_end(args);
+
+    log_record_count++;
+    PERF_END(PERF_KERNEL_LOG);
+}
+
+// ʽд¼
+void kernel_log_flush(void) {
+    while (log_record_count > 0) {
+        log_drain_one();
+    }
+}
+
+// ȡ־ı
+const char* kernel_log_buffer(uint32_t* len) {
+    kernel_log_flush();
+    if (len) *len = log_buffer_pos;
+    return log_buffer;
 }
 
 // ںpanic
 void kernel_panic(const char* msg) {
     kernel_log(LOG_EMERG, "KERNEL PANIC: %s", msg);
+    kernel_log_flush();
 
     // ʵںУֹͣϵͳ
     while (1) {
@@ -2,6 +2,8 @@
 #define _LOG_H
 
 #include "os_types.h"
+#include "config.h"
+#include <stdarg.h>
 
 typedef enum {
     LOG_EMERG,
@@ -14,15 +16,53 @@ typedef enum {
     LOG_DEBUG
 } log_level_t;
 
+// ־ (ӳٸʽʱԭʼ)
+typedef union log_arg_t {
+    int64_t i;
+    uint64_t u;
+    double f;
+    const char* s;
+} log_arg_t;
+
+// ʽ־¼ֻfmtָԭʼ%sƵ¼
+typedef struct log_record_t {
+    const char* fmt;
+    uint8_t level;
+    uint8_t argc;
+    log_arg_t args[LOG_MAX_ARGS];
+    char strs[LOG_RECORD_STR_SIZE];
+} log_record_t;
+
+// ־״̬ (ÿںһ)
+typedef struct log_state_t {
+    char log_buffer[LOG_BUFFER_SIZE];
+    uint32_t log_buffer_pos;
+    log_record_t log_records[LOG_RECORD_COUNT];
+    uint32_t log_record_head;    // Ĵʽ¼
+    uint32_t log_record_count;   // ʽ¼
+} log_state_t;
+
+// ڼжϣlevelΪʱü־䣨ֵᱻ
+#define KLOG_ENABLED(level) ((level) <= KERNEL_LOG_LEVEL)
+
 // ں־
 void kernel_log_init(void);
-void kernel_log(log_level_t level, const char* fmt, ...);
+void kernel_log_write(log_level_t level, const char* fmt, ...);  // ֻ¼fmtָԭʼ
+void kernel_log_flush(void);                                     // ʽд¼
+const char* kernel_log_buffer(uint32_t* len);                    // ˢ²־ı
 void kernel_panic(const char* msg);
 
+// ں˸ʽ (֧ %d %i %u %x %X %c %s %f %%Լ - 0  .)
+int kernel_vsnprintf(char* buf, uint32_t size, const char* fmt, va_list args);
+int kernel_snprintf(char* buf, uint32_t size, const char* fmt, ...);
+
+#define kernel_log(level, ...) \
+    do { if (KLOG_ENABLED(level)) kernel_log_write((level), __VA_ARGS__); } while (0)
+
 #ifdef DEBUG
 #define DEBUG_PRINT(fmt, ...) kernel_log(LOG_DEBUG, "[DEBUG] " fmt, ##__VA_ARGS__)
 #else
-#define DEBUG_PRINT(fmt, ...)
+#define DEBUG_PRINT(fmt, ...) ((void)0)
 #endif
 
 #endif // _LOG_H
\ No newline at end of file
@@ -4,50 +4,108 @@
 #include "process.h"  // process.h
 #include "partition.h"
 #include "config.h"
+#include "perf.h"
+#include "frag.h"
+#include "adapt.h"
+#include "kernel.h"
+#include "traffic.h"
+#include "io.h"
+#include "swap.h"
 
 
-extern uint32_t partition_count;
-extern partition_t partition_table[MAX_PARTITIONS];
-extern process_t process_table[MAX_PROCESSES];
-
-allocation_strategy_t current_strategy = BEST_FIT;  // Ĭϲ
-
 
 // ڴʼ
 void memory_init(void) {
     current_strategy = DEFAULT_ALLOCATION_STRATEGY;
+    frag_reset();
+    adapt_reset();
+    traffic_reset();
+    io_reset();
+    swap_reset();
     DEBUG_PRINT("Memory manager initialized with strategy %d", current_strategy);
 }
 
+// ѡз
+// ɨ (partition_index)partition_tֶ
+static partition_t* select_partition(uint32_t size, allocation_strategy_t strategy) {
+    const uint32_t* sizes = partition_index.size;
+    const uint8_t* states = partition_index.state;
+    partition_t* selected = NULL;
+    uint32_t selected_size = 0;
+
+    switch (strategy) {
+        case FIRST_FIT:
+            // ״Ӧ: ַ͵Ŀɷ
+            for (uint32_t i = 1; i < partition_count; i++) {
+                if (states[i] == PARTITION_FREE && sizes[i] >= size) {
+                    return &partition_table[i];
+                }
+            }
+            break;
+
+        case WORST_FIT:
+            // Ӧ: Ŀɷ
+            for (uint32_t i = 1; i < partition_count; i++) {
+                if (states[i] == PARTITION_FREE && sizes[i] >= size && (!selected || sizes[i] > selected_size)) {
+                    selected = &partition_table[i];
+                    selected_size = sizes[i];
+                }
+            }
+            break;
+
+        case BEST_FIT:
+        default:
+            selected = find_free_partition(size);
+            break;
+    }
+
+    return selected;
+}
+
 // ڴ - ̶ϵͳ
 int allocate_memory(process_t* proc, allocation_strategy_t strategy) {
+    PERF_BEGIN();
     if (!proc || proc->memory_size == 0) {
+        PERF_END(PERF_ALLOCATE_MEMORY);
         return -1;
     }
 
     DEBUG_PRINT("Allocating memory for PID=%d, Size=%d, Strategy=%d",
         proc->pid, proc->memory_size, strategy);
 
-    // ڹ̶ϵͳУֻѰҺʴСķ
-    partition_t* selected = find_free_partition(proc->memory_size);
+    // ڹ̶ϵͳУڿзѡ
+    partition_t* selected = select_partition(proc->memory_size, strategy);
+
+    // µĽ̿Իȼ͵Ľ
+    if (!selected && proc->state == PROC_CREATED && swap_make_room(proc)) {
+        selected = select_partition(proc->memory_size, strategy);
+    }
 
     if (!selected) {
         kernel_log(LOG_WARNING, "No suitable partition for PID=%d (size=%d)",
             proc->pid, proc->memory_size);
+        frag_on_failure(proc->memory_size);
+        adapt_record_request(proc->memory_size, 0);
+        PERF_END(PERF_ALLOCATE_MEMORY);
         return -1;
     }
 
     // 
     if (allocate_partition(selected, proc) != 0) {
+        PERF_END(PERF_ALLOCATE_MEMORY);
         return -1;
     }
 
+    adapt_record_request(proc->memory_size, 1);
+    PERF_END(PERF_ALLOCATE_MEMORY);
     return 0;
 }
 
 // ͷڴ
 void free_memory(process_t* proc) {
+    PERF_BEGIN();
     if (!proc || proc->state == PROC_TERMINATED) {
+        PERF_END(PERF_FREE_MEMORY);
         return;
     }
 
@@ -63,25 +121,38 @@ void free_memory(process_t* proc) {
 
     // ֹ
     terminate_process(proc);
+    PERF_END(PERF_FREE_MEMORY);
 }
 
 // ڴ (ڴ) - ڹ̶ϵͳУղ
-void compact_memory(void) {
+// ̲ƶΪ絽ûпзŵµḶ̌ղԻٵĽ (swap.h)
+// ڳ䣻Ľ֮Уᱻֹ
+int compact_memory(void) {
     kernel_log(LOG_INFO, "Compacting memory in fixed partition system");
 
-    // ڹ̶ϵͳУղĺɱͬ
-    // ǽֹụַ̂ṹ
+    uint32_t now = get_current_time();
+    uint32_t largest = get_largest_free_block();
+    process_t* blocked = NULL;
     for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
-        if (process_table[i].state != PROC_TERMINATED && process_table[i].pid != 0) {
-            // ֹֻǲϵͳ
-            if (process_table[i].pid > 0) {
-                terminate_process(&process_table[i]);
-            }
-        }
+        process_t* proc = &process_table[i];
+        if (proc->state != PROC_CREATED || proc->arrival_time > now || proc->memory_size <= largest) continue;
+        if (!blocked || proc->arrival_time < blocked->arrival_time) blocked = proc;
+    }
+    if (!blocked) {
+        kernel_log(LOG_INFO, "Memory compaction: no arrived process is waiting for a partition");
+        return -1;
+    }
+
+    if (!swap_reclaim(blocked->memory_size, NULL) || allocate_memory(blocked, current_strategy) != 0) {
+        kernel_log(LOG_WARNING, "Memory compaction: cannot free a partition for PID=%d (size=%d)",
+            blocked->pid, blocked->memory_size);
+        return -1;
     }
+    scheduler_add_process(blocked);
 
-    kernel_log(LOG_INFO, "Memory compaction completed - all user processes terminated");
+    kernel_log(LOG_INFO, "Memory compaction completed - PID=%d admitted", blocked->pid);
     dump_memory_map();
+    return 0;
 }
 
 // ȡܿڴ
@@ -122,4 +193,21 @@ void dump_memory_statistics(void) {
     kernel_log(LOG_INFO, "  Largest Free Block: %d bytes", largest_block);
     kernel_log(LOG_INFO, "  External Fragmentation: %.1f%%",
         (largest_block > 0) ? (float)(total_free - largest_block) * 100 / total_free : 0.0f);
+
+    // ڼƬͳ
+    frag_stats_t fs;
+    frag_get_stats(&fs);
+    kernel_log(LOG_INFO, "  Internal Waste: %u bytes (%.1f%% of allocated)",
+        fs.waste_current, fs.allocated_current ? (float)fs.waste_current * 100 / fs.allocated_current : 0.0f);
+    kernel_log(LOG_INFO, "  Allocations: %lu, Avg Waste: %.1f bytes, Max Waste: %u bytes",
+        (unsigned long)fs.allocations, fs.allocations ? (double)fs.waste_total / fs.allocations : 0.0,
+        fs.waste_max);
+    kernel_log(LOG_INFO, "  Allocation Failures: %lu (%lu with enough total free memory)",
+        (unsigned long)fs.alloc_failures, (unsigned long)fs.failures_despite_free);
+    kernel_log(LOG_INFO, "  Avg Internal/External Fragmentation: %.1f%% / %.1f%% over %lu ticks",
+        fs.mean_internal_frag * 100, fs.mean_external_frag * 100, (unsigned long)fs.samples);
+
+#if KERNEL_PERF
+    dump_perf_counters();
+#endif
 }
\ No newline at end of file
@@ -12,14 +12,14 @@ typedef enum {
     WORST_FIT       // Ӧ
 } allocation_strategy_t;
 
-// ȫֱ
-extern allocation_strategy_t current_strategy;
+// ǰ current_strategy λں (kernel.h)
 
 // ںAPI
 void memory_init(void);
 int allocate_memory(process_t* proc, allocation_strategy_t strategy);
 void free_memory(process_t* proc);
-void compact_memory(void);  // 㷨
+int compact_memory(void);            // 㷨: ̣ΪһŲµĽڳ
+void advanced_compact_memory(void);  // ΪзŲµĽڳ
 uint32_t get_total_free_memory(void);
 uint32_t get_largest_free_block(void);
 void dump_memory_statistics(void);
@@ -0,0 +1,166 @@
+#include <stdlib.h>
+#include "os_types.h"
+#include "config.h"
+#include "log.h"
+#include "kernel.h"
+#include "mtalloc.h"
+
+mt_pool_t* mt_pool_create(void) {
+    kernel_ctx_t* ctx = kernel_ctx_current();
+    mt_pool_t* pool = (mt_pool_t*)calloc(1, sizeof(mt_pool_t));
+    if (!pool) return NULL;
+    pool->ctx = ctx;
+
+    // 大小类: 用户分区的不同大小，升序
+    for (uint32_t i = 1; i < ctx->part_count; i++) {
+        uint32_t size = ctx->parts[i].size;
+        uint32_t c = 0;
+        while (c < pool->class_count && pool->class_size[c] < size) c++;
+        if (c < pool->class_count && pool->class_size[c] == size) continue;
+        if (pool->class_count == MT_MAX_CLASSES) {
+            kernel_log(LOG_ERR, "MT pool: more than %d partition sizes", MT_MAX_CLASSES);
+            free(pool);
+            return NULL;
+        }
+        for (uint32_t k = pool->class_count; k > c; k--) {
+            pool->class_size[k] = pool->class_size[k - 1];
+        }
+        pool->class_size[c] = size;
+        pool->class_count++;
+    }
+
+    // 空闲分区压入所属类的栈 (此时还没有其他线程)
+    for (uint32_t c = 0; c < MT_MAX_CLASSES; c++) {
+        tag_stack_init(&pool->free[c]);
+    }
+    for (uint32_t i = 1; i < ctx->part_count; i++) {
+        uint32_t c = 0;
+        while (pool->class_size[c] != ctx->parts[i].size) c++;
+        pool->class_of[i] = (uint8_t)c;
+        if (ctx->parts[i].state == PARTITION_FREE) {
+            tag_stack_push(&pool->free[c], pool->next, i, NULL);
+        }
+    }
+    return pool;
+}
+
+void mt_pool_destroy(mt_pool_t* pool) {
+    free(pool);
+}
+
+void mt_cache_init(mt_cache_t* cache, uint32_t capacity) {
+    memset(cache, 0, sizeof(*cache));
+    cache->capacity = capacity < MT_CACHE_SIZE ? capacity : MT_CACHE_SIZE;
+}
+
+static uint32_t batch_size(const mt_cache_t* cache) {
+    return cache->capacity < MT_BATCH ? cache->capacity : MT_BATCH;
+}
+
+// 从共享栈取至多一批c类分区，返回取到的个数
+static uint32_t refill(mt_pool_t* pool, mt_cache_t* cache, uint32_t c) {
+    uint32_t want = batch_size(cache);
+    uint32_t n = 0;
+
+    while (n < want) {
+        uint32_t i = tag_stack_pop(&pool->free[c], pool->next, &cache->retries);
+        if (i == TAG_STACK_EMPTY) break;
+        cache->slots[c][cache->count[c]++] = i;
+        n++;
+    }
+    cache->refills++;
+    return n;
+}
+
+// 把缓存底部 (最久未用) 的n个c类分区链成一串，一次压回共享栈
+static void flush(mt_pool_t* pool, mt_cache_t* cache, uint32_t c, uint32_t n) {
+    uint32_t* slots = cache->slots[c];
+
+    for (uint32_t k = 0; k + 1 < n; k++) {
+        __atomic_store_n(&pool->next[slots[k]], slots[k + 1], __ATOMIC_RELAXED);
+    }
+    tag_stack_push_chain(&pool->free[c], pool->next, slots[0], slots[n - 1], &cache->retries);
+
+    cache->count[c] -= n;
+    for (uint32_t k = 0; k < cache->count[c]; k++) {
+        slots[k] = slots[k + n];
+    }
+    cache->flushes++;
+}
+
+void mt_cache_flush(mt_pool_t* pool, mt_cache_t* cache) {
+    for (uint32_t c = 0; c < pool->class_count; c++) {
+        if (cache->count[c]) flush(pool, cache, c, cache->count[c]);
+    }
+}
+
+// 取一个c类空闲分区: 有缓存时从缓存取 (空则先批量补充)，否则直接弹出共享栈
+static uint32_t take(mt_pool_t* pool, mt_cache_t* cache, uint32_t c) {
+    if (!cache->capacity) {
+        return tag_stack_pop(&pool->free[c], pool->next, &cache->retries);
+    }
+    if (!cache->count[c] && !refill(pool, cache, c)) return TAG_STACK_EMPTY;
+    return cache->slots[c][--cache->count[c]];
+}
+
+int mt_allocate_memory(mt_pool_t* pool, mt_cache_t* cache, process_t* proc) {
+    kernel_ctx_t* ctx = pool->ctx;
+    if (!proc || proc->memory_size == 0) return -1;
+
+    // 能容纳请求的最小类开始，本类取不到时用更大的类
+    uint32_t c = 0;
+    while (c < pool->class_count && pool->class_size[c] < proc->memory_size) c++;
+    for (; c < pool->class_count; c++) {
+        uint32_t i = take(pool, cache, c);
+        if (i == TAG_STACK_EMPTY) continue;
+
+        // 分区已从共享栈取出，只有本线程会写它的表项
+        partition_t* part = &ctx->parts[i];
+        process_info_t* info = &ctx->proc_info[proc - ctx->procs];
+        part->state = PARTITION_ALLOCATED;
+        part->owner_pid = proc->pid;
+        part->used_size = proc->memory_size;
+        ctx->part_index.state[i] = PARTITION_ALLOCATED;
+        info->memory_start = part->start;
+        info->memory_end = part->start + part->size - 1;
+        cache->allocs++;
+        return 0;
+    }
+    cache->failures++;
+    return -1;
+}
+
+void mt_free_memory(mt_pool_t* pool, mt_cache_t* cache, process_t* proc) {
+    kernel_ctx_t* ctx = pool->ctx;
+    if (!proc) return;
+    process_info_t* info = &ctx->proc_info[proc - ctx->procs];
+
+    // 分区按起始地址升序，二分查找进程的分区
+    uint32_t lo = 1, hi = ctx->part_count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (ctx->parts[mid].start < info->memory_start) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == ctx->part_count) return;
+    partition_t* part = &ctx->parts[lo];
+    if (part->start != info->memory_start || part->state != PARTITION_ALLOCATED || part->owner_pid != proc->pid) {
+        return;
+    }
+
+    part->state = PARTITION_FREE;
+    part->owner_pid = 0;
+    part->used_size = 0;
+    ctx->part_index.state[lo] = PARTITION_FREE;
+    info->memory_start = 0;
+    info->memory_end = 0;
+
+    uint32_t c = pool->class_of[lo];
+    if (!cache->capacity) {
+        tag_stack_push(&pool->free[c], pool->next, lo, &cache->retries);
+    } else {
+        if (cache->count[c] == cache->capacity) flush(pool, cache, c, batch_size(cache));
+        cache->slots[c][cache->count[c]++] = lo;
+    }
+    cache->frees++;
+}
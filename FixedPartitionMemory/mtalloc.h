@@ -0,0 +1,47 @@
+#ifndef _MTALLOC_H
+#define _MTALLOC_H
+
+#include "os_types.h"
+#include "config.h"
+#include "kernel.h"
+#include "tagstack.h"
+
+// 多线程分区分配 (可选模块)
+// 多个线程共享一个内核上下文的分区表，并发地为各自的进程分配和释放分区。
+// 空闲分区按分区大小分类，共享池中每类一个无锁下标栈 (tagstack.h)，取出/放回一个分区各是一次CAS；
+// 每个线程可以在自己的 mt_cache_t 中每类缓存至多 MT_CACHE_SIZE 个空闲分区，缓存空时从共享池取
+// MT_BATCH 个，满时把 MT_BATCH 个链成一串一次放回。请求按大小类最佳适应，本类没有空闲分区时用更大的类。
+// 池存在期间不能改变分区布局，也不能在该上下文上调用单线程的分配/释放API；
+// 并发路径不更新碎片统计和访存模型。缓存在其他线程中的空闲分区对本线程不可见
+
+// 线程私有的缓存 (每个线程一个，不与其他线程共享)
+typedef struct mt_cache_t {
+    uint32_t capacity;    // 每类最多缓存的分区数 (不超过MT_CACHE_SIZE)
+    uint32_t count[MT_MAX_CLASSES];
+    uint32_t slots[MT_MAX_CLASSES][MT_CACHE_SIZE];   // 缓存的空闲分区下标
+    uint64_t allocs;      // 成功分配次数
+    uint64_t frees;       // 释放次数
+    uint64_t refills;     // 从共享池批量取分区的次数
+    uint64_t flushes;     // 向共享池批量还分区的次数
+    uint64_t retries;     // 共享栈上CAS失败 (与其他线程冲突) 的次数
+    uint64_t failures;    // 分配失败次数
+} mt_cache_t;
+
+typedef struct mt_pool_t {
+    tag_stack_t free[MT_MAX_CLASSES];      // 各类的空闲分区栈
+    kernel_ctx_t* ctx;                     // 分区表所在的上下文
+    uint32_t class_count;
+    uint32_t class_size[MT_MAX_CLASSES];   // 各类的分区大小，升序
+    uint8_t class_of[MAX_PARTITIONS];      // 分区下标 -> 大小类
+    uint32_t next[MAX_PARTITIONS];         // 空闲栈中的链接
+} mt_pool_t;
+
+// 用当前线程绑定的上下文的分区表建池，分区大小超过MT_MAX_CLASSES种时返回NULL
+mt_pool_t* mt_pool_create(void);
+void mt_pool_destroy(mt_pool_t* pool);
+void mt_cache_init(mt_cache_t* cache, uint32_t capacity);  // capacity为0时不缓存，每次分配/释放直接操作共享栈
+void mt_cache_flush(mt_pool_t* pool, mt_cache_t* cache);   // 把缓存的分区全部还回共享池 (线程退出前调用)
+int mt_allocate_memory(mt_pool_t* pool, mt_cache_t* cache, process_t* proc);
+void mt_free_memory(mt_pool_t* pool, mt_cache_t* cache, process_t* proc);   // 只释放分区，不终止进程
+
+#endif // _MTALLOC_H
@@ -12,8 +12,19 @@ typedef int BOOL;
 
 // 
 #define MAX_MEMORY_SIZE 1024    // 1KBڴ
-#define MAX_PARTITIONS 16       // 
-#define MAX_PROCESSES 32        // 
+#ifndef MAX_PARTITIONS
+#define MAX_PARTITIONS 16       //  ( -DMAX_PARTITIONS=N )
+#endif
+#ifndef MAX_PROCESSES
+#define MAX_PROCESSES 32        //  ( -DMAX_PROCESSES=N )
+#endif
+
+// ֲ߳̾洢
+#if defined(_MSC_VER)
+#define KERNEL_THREAD_LOCAL __declspec(thread)
+#else
+#define KERNEL_THREAD_LOCAL __thread
+#endif
 
 // ڼĺ
 #ifdef __linux__
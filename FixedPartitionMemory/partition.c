@@ -2,14 +2,40 @@
 #include "log.h"
 #include "partition.h"
 #include "config.h"
+#include "perf.h"
+#include "frag.h"
 #include "process.h"  // process.h
+#include "kernel.h"
+#include "traffic.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#if PARTITION_SEARCH_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define PARTITION_SSE2 1
+#include <emmintrin.h>
+#else
+#define PARTITION_SSE2 0
+#endif
 
 // Ԥ̶С - 8̶ (ܺ896ֽ)
 static const uint32_t FIXED_PARTITION_SIZES[] = {128, 128, 128, 128, 96, 96, 96, 96};
 #define FIXED_PARTITION_COUNT (sizeof(FIXED_PARTITION_SIZES) / sizeof(FIXED_PARTITION_SIZES[0]))
 
-partition_t partition_table[MAX_PARTITIONS];
-uint32_t partition_count = 0;
+// ǰʹõķ (partition_set_layout()滻countΪ0ʱʹԤС)
+#define layout_sizes (kernel_ctx_current()->layout_sizes)
+#define layout_count (kernel_ctx_current()->layout_count)
+
+// partition_table [first, end) ֶͬ
+static void index_sync(uint32_t first, uint32_t end) {
+    for (uint32_t i = first; i < end; i++) {
+        partition_index.size[i] = partition_table[i].size;
+        partition_index.state[i] = (uint8_t)partition_table[i].state;
+    }
+}
+
+void partition_sync_index(void) {
+    index_sync(0, partition_count);
+}
 
 // ʼ - ̶ϵͳ
 void partition_init(void) {
@@ -17,6 +43,7 @@ void partition_init(void) {
     for (uint32_t i = 0; i < MAX_PARTITIONS; i++) {
         partition_table[i].state = PARTITION_FREE;
         partition_table[i].owner_pid = 0;
+        partition_table[i].used_size = 0;
     }
 
     // ϵͳ
@@ -30,9 +57,12 @@ void partition_init(void) {
     // ̶ - ڴʣಿֿʼ
     uint32_t current_addr = OS_PARTITION_SIZE;
 
-    // ԤС̶
-    for (uint32_t size_idx = 0; size_idx < FIXED_PARTITION_COUNT && partition_count < MAX_PARTITIONS; size_idx++) {
-        uint32_t partition_size = FIXED_PARTITION_SIZES[size_idx];
+    // ̶ִ
+    const uint32_t* sizes = layout_count ? layout_sizes : FIXED_PARTITION_SIZES;
+    uint32_t count = layout_count ? layout_count : (uint32_t)FIXED_PARTITION_COUNT;
+
+    for (uint32_t size_idx = 0; size_idx < count && partition_count < MAX_PARTITIONS; size_idx++) {
+        uint32_t partition_size = sizes[size_idx];
         
         if (current_addr + partition_size <= MEMORY_SIZE) {
             partition_table[partition_count].start = current_addr;
@@ -45,27 +75,181 @@ void partition_init(void) {
         }
     }
 
+    index_sync(0, partition_count);
+
     DEBUG_PRINT("Fixed partition table initialized with %d partitions", partition_count);
     dump_memory_map();
 }
 
-// ҿз - ̶ϵͳҪҵСʵķ
-partition_t* find_free_partition(uint32_t size) {
-    partition_t* best_fit = NULL;
+// ÷֣´partition_init()ЧcountΪ0ָԤ岼
+int partition_set_layout(const uint32_t* sizes, uint32_t count) {
+    uint32_t total = 0;
+
+    if (count >= MAX_PARTITIONS) {
+        kernel_log(LOG_ERR, "Layout has %d partitions, at most %d allowed", count, MAX_PARTITIONS - 1);
+        return -1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (sizes[i] < MIN_PARTITION_SIZE) {
+            kernel_log(LOG_ERR, "Layout partition %d is smaller than %d bytes", i, MIN_PARTITION_SIZE);
+            return -1;
+        }
+        total += sizes[i];
+    }
+    if (total > MEMORY_SIZE - OS_PARTITION_SIZE) {
+        kernel_log(LOG_ERR, "Layout needs %d bytes, only %d available", total, MEMORY_SIZE - OS_PARTITION_SIZE);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        layout_sizes[i] = sizes[i];
+    }
+    layout_count = count;
+    return 0;
+}
+
+// ǰ֣ط
+uint32_t partition_get_layout(uint32_t* sizes, uint32_t max) {
+    const uint32_t* src = layout_count ? layout_sizes : FIXED_PARTITION_SIZES;
+    uint32_t count = layout_count ? layout_count : (uint32_t)FIXED_PARTITION_COUNT;
+
+    if (count > max) count = max;
+    for (uint32_t i = 0; i < count; i++) {
+        sizes[i] = src[i];
+    }
+    return count;
+}
+
+// ļز: СԿհ׻򶺺ŷָ'#'ͷβΪע
+// (ϵʱ飬ܴʱռջʧʱǰֲ)
+int partition_load_layout(const char* path) {
+    uint32_t* sizes;
+    uint32_t count = 0;
+    char line[256];
+    FILE* f = fopen(path, "r");
+
+    if (!f) {
+        kernel_log(LOG_ERR, "Cannot open layout file %s", path);
+        return -1;
+    }
+    sizes = (uint32_t*)malloc(sizeof(uint32_t) * MAX_PARTITIONS);
+    if (!sizes) {
+        fclose(f);
+        kernel_log(LOG_ERR, "Out of memory loading layout file %s", path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        char* p = line;
+        while (*p && *p != '#') {
+            if (*p >= '0' && *p <= '9') {
+                uint32_t v = 0;
+                while (*p >= '0' && *p <= '9') {
+                    v = v * 10 + (uint32_t)(*p++ - '0');
+                }
+                if (count == MAX_PARTITIONS) {
+                    fclose(f);
+                    free(sizes);
+                    kernel_log(LOG_ERR, "Layout file %s has too many partitions", path);
+                    return -1;
+                }
+                sizes[count++] = v;
+            } else {
+                p++;
+            }
+        }
+    }
+    fclose(f);
+
+    int rc = -1;
+    if (count == 0) {
+        kernel_log(LOG_ERR, "Layout file %s is empty", path);
+    } else {
+        rc = partition_set_layout(sizes, count);
+    }
+    free(sizes);
+    return rc;
+}
+
+#if PARTITION_SSE2
+
+// ÿαȽ4ֱͨ¼Сֵ±꣬ͨԼ
+// SSE2û޷32λȽϣ0x80000000зűȽ
+static uint32_t best_fit_index(uint32_t size) {
+    const uint32_t* sizes = partition_index.size;
+    const uint8_t* states = partition_index.state;
+    const __m128i bias = _mm_set1_epi32((int)0x80000000u);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i want = _mm_set1_epi32((int)size);
+    const __m128i want_b = _mm_xor_si128(want, bias);
+    const __m128i free_state = _mm_set1_epi32(PARTITION_FREE);
+    const __m128i count = _mm_set1_epi32((int)partition_count);
+    const __m128i four = _mm_set1_epi32(4);
+    __m128i idx = _mm_setr_epi32(0, 1, 2, 3);
+    __m128i best_b = _mm_set1_epi32(0x7FFFFFFF);   // ֵ0xFFFFFFFF (ƫú)汾ĳֵͬ
+    __m128i best_idx = zero;
+
+    for (uint32_t i = 0; i < partition_count; i += 4) {
+        __m128i sz = _mm_loadu_si128((const __m128i*)&sizes[i]);
+        int st4;
+        memcpy(&st4, &states[i], sizeof(st4));
+        __m128i st = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(st4), zero), zero);
+
+        // Сɣû (0 < idx < partition_count)
+        __m128i ok = _mm_cmpeq_epi32(st, free_state);
+        ok = _mm_and_si128(ok, _mm_and_si128(_mm_cmpgt_epi32(idx, zero), _mm_cmplt_epi32(idx, count)));
+        ok = _mm_andnot_si128(_mm_cmpgt_epi32(want_b, _mm_xor_si128(sz, bias)), ok);
+
+        __m128i diff_b = _mm_xor_si128(_mm_sub_epi32(sz, want), bias);
+        __m128i better = _mm_and_si128(ok, _mm_cmplt_epi32(diff_b, best_b));
+        best_b = _mm_or_si128(_mm_and_si128(better, diff_b), _mm_andnot_si128(better, best_b));
+        best_idx = _mm_or_si128(_mm_and_si128(better, idx), _mm_andnot_si128(better, best_idx));
+        idx = _mm_add_epi32(idx, four);
+    }
+
+    int32_t lane_diff[4];
+    uint32_t lane_idx[4];
+    _mm_storeu_si128((__m128i*)lane_diff, best_b);
+    _mm_storeu_si128((__m128i*)lane_idx, best_idx);
+
+    // ֵͬʱȡ±Сģ˳ɨһ
+    int32_t diff = 0x7FFFFFFF;
+    uint32_t found = 0;
+    for (int l = 0; l < 4; l++) {
+        if (lane_diff[l] < diff || (lane_diff[l] == diff && lane_idx[l] < found)) {
+            diff = lane_diff[l];
+            found = lane_idx[l];
+        }
+    }
+    return found;
+}
+
+#else
+
+static uint32_t best_fit_index(uint32_t size) {
+    const uint32_t* sizes = partition_index.size;
+    const uint8_t* states = partition_index.state;
+    uint32_t found = 0;
     uint32_t best_fit_diff = 0xFFFFFFFF;
-    
-    // ڹ̶ϵͳУѰָܹССʷ
+
     for (uint32_t i = 1; i < partition_count; i++) {
-        if (partition_table[i].state == PARTITION_FREE && partition_table[i].size >= size) {
-            // Ѱƥ䣨С㹻ķ
-            uint32_t diff = partition_table[i].size - size;
-            if (diff < best_fit_diff) {
-                best_fit_diff = diff;
-                best_fit = &partition_table[i];
-            }
+        if (states[i] == PARTITION_FREE && sizes[i] >= size && sizes[i] - size < best_fit_diff) {
+            best_fit_diff = sizes[i] - size;
+            found = i;
         }
     }
-    
+    return found;
+}
+
+#endif
+
+// ҿз - ̶ϵͳҪҵСʵķ
+// ѰָܹССƥ䣩ֻɨ
+partition_t* find_free_partition(uint32_t size) {
+    PERF_BEGIN();
+    uint32_t i = best_fit_index(size);
+    partition_t* best_fit = i ? &partition_table[i] : NULL;
+
+    PERF_END(PERF_FIND_FREE_PARTITION);
     return best_fit;
 }
 
@@ -85,8 +269,12 @@ int allocate_partition(partition_t* part, process_t* proc) {
     // 
     part->state = PARTITION_ALLOCATED;
     part->owner_pid = proc->pid;
-    proc->memory_start = part->start;
-    proc->memory_end = part->start + part->size - 1;
+    part->used_size = proc->memory_size;
+    partition_index.state[part - partition_table] = PARTITION_ALLOCATED;
+    process_info(proc)->memory_start = part->start;
+    process_info(proc)->memory_end = part->start + part->size - 1;
+    frag_on_allocate(part, proc->memory_size);
+    traffic_on_allocate(part);
 
     DEBUG_PRINT("Partition allocated: PID=%d, Start=0x%x, Size=%d",
         proc->pid, part->start, part->size);
@@ -104,8 +292,12 @@ void free_partition(partition_t* part) {
         part->start, part->size, part->owner_pid);
 
     // ͷŷ
+    frag_on_free(part);
+    traffic_on_free(part);
     part->state = PARTITION_FREE;
     part->owner_pid = 0;
+    part->used_size = 0;
+    partition_index.state[part - partition_table] = PARTITION_FREE;
 }
 
 // ϲڿз - ڹ̶ϵͳУãΪС̶
@@ -114,6 +306,55 @@ void merge_adjacent_free_partitions(void) {
     // ˺Ϊ˼ݽӿ
 }
 
+// ֿз: ǰ벿ֱsizeֽڣΪ¿з
+int partition_split(uint32_t index, uint32_t size) {
+    if (index == 0 || index >= partition_count || partition_count >= MAX_PARTITIONS) {
+        return -1;
+    }
+
+    partition_t* part = &partition_table[index];
+    if (part->state != PARTITION_FREE || size < MIN_PARTITION_SIZE || part->size < size + MIN_PARTITION_SIZE) {
+        return -1;
+    }
+
+    for (uint32_t i = partition_count; i > index + 1; i--) {
+        partition_table[i] = partition_table[i - 1];
+    }
+    partition_table[index + 1].start = part->start + size;
+    partition_table[index + 1].size = part->size - size;
+    partition_table[index + 1].state = PARTITION_FREE;
+    partition_table[index + 1].owner_pid = 0;
+    partition_table[index + 1].used_size = 0;
+    part->size = size;
+    partition_count++;
+    index_sync(index, partition_count);
+
+    DEBUG_PRINT("Partition split: Start=0x%x, Sizes=%d+%d", part->start, size, partition_table[index + 1].size);
+    return 0;
+}
+
+// ϲڵз index  index+1
+int partition_merge(uint32_t index) {
+    if (index == 0 || index + 1 >= partition_count) {
+        return -1;
+    }
+
+    partition_t* part = &partition_table[index];
+    if (part->state != PARTITION_FREE || partition_table[index + 1].state != PARTITION_FREE) {
+        return -1;
+    }
+
+    part->size += partition_table[index + 1].size;
+    for (uint32_t i = index + 1; i + 1 < partition_count; i++) {
+        partition_table[i] = partition_table[i + 1];
+    }
+    partition_count--;
+    index_sync(index, partition_count);
+
+    DEBUG_PRINT("Partition merged: Start=0x%x, Size=%d", part->start, part->size);
+    return 0;
+}
+
 // תڴӳ
 void dump_memory_map(void) {
     kernel_log(LOG_INFO, "Memory Map:");
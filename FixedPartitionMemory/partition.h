@@ -19,11 +19,20 @@ typedef struct partition_t {
     uint32_t size;             // С
     partition_state_t state;   // ״̬
     uint32_t owner_pid;        // PID (0ʾ)
+    uint32_t used_size;        // ʵҪĴС (ΪڲƬ)
 } partition_t;
 
-// ȫֱ
-extern partition_t partition_table[MAX_PARTITIONS];
-extern uint32_t partition_count;
+// õֶΣṹ (partition.cάpartition_tableͬ)
+// ֻɨ飬start/owner_pid/used_sizeֶpartition_tУ
+// 4룬SIMDȡʱԽ
+#define PARTITION_INDEX_SLOTS ((MAX_PARTITIONS + 3) & ~3u)
+
+typedef struct partition_index_t {
+    uint32_t size[PARTITION_INDEX_SLOTS];   // С
+    uint8_t state[PARTITION_INDEX_SLOTS];   // partition_state_t
+} partition_index_t;
+
+//  partition_table / partition_count  partition_index λں (kernel.h)
 
 // ںAPI
 void partition_init(void);
@@ -31,6 +40,14 @@ partition_t* find_free_partition(uint32_t size);
 int allocate_partition(partition_t* part, process_t* proc);
 void free_partition(partition_t* part);
 void merge_adjacent_free_partitions(void);
+int partition_split(uint32_t index, uint32_t size);
+int partition_merge(uint32_t index);
 void dump_memory_map(void);
+void partition_sync_index(void);   // ƹģֱ޸partition_tableؽ
+
+//  (´partition_init()Ч)
+int partition_set_layout(const uint32_t* sizes, uint32_t count);
+uint32_t partition_get_layout(uint32_t* sizes, uint32_t max);
+int partition_load_layout(const char* path);
 
 #endif // _PARTITION_H
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "os_types.h"
+#include "log.h"
+#include "perf.h"
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define PERF_USE_TSC 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define PERF_USE_TSC 0
+#endif
+
+#define PERF_CALIBRATE_NS 10000000ull   // TSC换算至少需要10ms的参考区间
+
+// 单个计数器
+typedef struct perf_counter_data_t {
+    uint64_t calls;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+    uint64_t hist[PERF_HIST_BUCKETS];
+} perf_counter_data_t;
+
+static const char* perf_names[PERF_COUNTER_COUNT] = {
+    "allocate_memory",
+    "free_memory",
+    "find_free_partition",
+    "scheduler_get_next",
+    "kernel_log",
+    "process_traffic"
+};
+
+// 每个线程独立计数，并行模拟时互不干扰
+static KERNEL_THREAD_LOCAL perf_counter_data_t perf_data[PERF_COUNTER_COUNT];
+static KERNEL_THREAD_LOCAL uint64_t calib_ticks;   // 计时起点 (TSC)
+static KERNEL_THREAD_LOCAL uint64_t calib_ns;      // 计时起点 (纳秒)
+
+static uint64_t clock_ns(void) {
+    struct timespec ts;
+#ifdef _WIN32
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t perf_now(void) {
+#if PERF_USE_TSC
+    return __rdtsc();
+#else
+    return clock_ns();
+#endif
+}
+
+// 最高有效位位置 (v > 0)
+static uint32_t msb64(uint64_t v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanReverse64(&idx, v);
+    return (uint32_t)idx;
+#elif defined(__GNUC__)
+    return 63u - (uint32_t)__builtin_clzll(v);
+#else
+    uint32_t n = 0;
+    while (v >>= 1) n++;
+    return n;
+#endif
+}
+
+// 值 -> 直方图桶：小于 2*SUB 的值各占一个桶，之后每个2的幂区间分 SUB 个子桶
+static uint32_t perf_bucket(uint64_t v) {
+    if (v < 2 * PERF_HIST_SUB_BUCKETS) {
+        return (uint32_t)v;
+    }
+    uint32_t msb = msb64(v);
+    uint32_t shift = msb - PERF_HIST_SUB_BITS;
+    uint32_t sub = (uint32_t)(v >> shift) - PERF_HIST_SUB_BUCKETS;
+    return 2 * PERF_HIST_SUB_BUCKETS + (msb - PERF_HIST_SUB_BITS - 1) * PERF_HIST_SUB_BUCKETS + sub;
+}
+
+// 桶 -> 区间中点
+static double perf_bucket_value(uint32_t idx) {
+    if (idx < 2 * PERF_HIST_SUB_BUCKETS) {
+        return idx;
+    }
+    uint32_t k = idx - 2 * PERF_HIST_SUB_BUCKETS;
+    uint32_t shift = k / PERF_HIST_SUB_BUCKETS + 1;
+    uint64_t lower = (uint64_t)(PERF_HIST_SUB_BUCKETS + k % PERF_HIST_SUB_BUCKETS) << shift;
+    return (double)lower + (double)((1ull << shift) - 1) / 2;
+}
+
+static double perf_percentile(const perf_counter_data_t* d, double pct) {
+    uint64_t target = (uint64_t)(d->calls * pct / 100.0 + 0.999999);
+    uint64_t seen = 0;
+
+    if (target == 0) target = 1;
+    for (uint32_t i = 0; i < PERF_HIST_BUCKETS; i++) {
+        seen += d->hist[i];
+        if (seen >= target) {
+            // 桶中点可能超出实际记录的范围
+            double v = perf_bucket_value(i);
+            if (v < (double)d->min) v = (double)d->min;
+            if (v > (double)d->max) v = (double)d->max;
+            return v;
+        }
+    }
+    return (double)d->max;
+}
+
+// 每个时间戳单位对应的纳秒数
+static double perf_ns_per_tick(void) {
+#if PERF_USE_TSC
+    uint64_t ns = clock_ns();
+    if (calib_ns == 0) {
+        calib_ns = ns;
+        calib_ticks = perf_now();
+    }
+    while (ns - calib_ns < PERF_CALIBRATE_NS) {
+        ns = clock_ns();
+    }
+    uint64_t ticks = perf_now() - calib_ticks;
+    return ticks ? (double)(ns - calib_ns) / (double)ticks : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+void perf_record(perf_counter_t id, uint64_t elapsed) {
+    perf_counter_data_t* d = &perf_data[id];
+
+    if (calib_ns == 0) {
+        calib_ns = clock_ns();
+        calib_ticks = perf_now();
+    }
+    if (d->calls == 0 || elapsed < d->min) d->min = elapsed;
+    if (elapsed > d->max) d->max = elapsed;
+    d->calls++;
+    d->total += elapsed;
+    d->hist[perf_bucket(elapsed)]++;
+}
+
+void perf_reset(void) {
+    memset(perf_data, 0, sizeof(perf_data));
+}
+
+int perf_get_stats(perf_counter_t id, perf_stats_t* stats) {
+    if (id >= PERF_COUNTER_COUNT || !stats) {
+        return -1;
+    }
+
+    const perf_counter_data_t* d = &perf_data[id];
+    double scale = d->calls ? perf_ns_per_tick() : 1.0;
+
+    stats->name = perf_names[id];
+    stats->calls = d->calls;
+    stats->total_ns = d->total * scale;
+    stats->min_ns = d->min * scale;
+    stats->max_ns = d->max * scale;
+    stats->mean_ns = d->calls ? stats->total_ns / d->calls : 0;
+    stats->p50_ns = d->calls ? perf_percentile(d, 50) * scale : 0;
+    stats->p90_ns = d->calls ? perf_percentile(d, 90) * scale : 0;
+    stats->p99_ns = d->calls ? perf_percentile(d, 99) * scale : 0;
+    return 0;
+}
+
+// 转储性能计数器
+void dump_perf_counters(void) {
+    kernel_log(LOG_INFO, "Perf Counters:");
+    if (!KERNEL_PERF) {
+        kernel_log(LOG_INFO, "  disabled (build with -DKERNEL_PERF=1)");
+        return;
+    }
+
+    kernel_log(LOG_INFO, "  %-20s %10s %9s %9s %9s %9s", "Function", "Calls", "Avg(ns)", "P50", "P99", "Max");
+    for (uint32_t i = 0; i < PERF_COUNTER_COUNT; i++) {
+        perf_stats_t st;
+        perf_get_stats((perf_counter_t)i, &st);
+        kernel_log(LOG_INFO, "  %-20s %10lu %9.1f %9.1f %9.1f %9.1f",
+            st.name, (unsigned long)st.calls, st.mean_ns, st.p50_ns, st.p99_ns, st.max_ns);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef _PERF_H
+#define _PERF_H
+
+#include "os_types.h"
+#include "config.h"
+
+// 热路径性能计数器
+// 编译时加 -DKERNEL_PERF=1 启用；关闭时 PERF_BEGIN/PERF_END 展开为空，没有任何开销
+typedef enum {
+    PERF_ALLOCATE_MEMORY,
+    PERF_FREE_MEMORY,
+    PERF_FIND_FREE_PARTITION,
+    PERF_SCHED_GET_NEXT,
+    PERF_KERNEL_LOG,
+    PERF_TRAFFIC,
+    PERF_COUNTER_COUNT
+} perf_counter_t;
+
+// 对数-线性直方图：每个2的幂区间再分 PERF_HIST_SUB_BUCKETS 个子桶 (相对误差 < 12.5%)
+#define PERF_HIST_SUB_BITS 3
+#define PERF_HIST_SUB_BUCKETS (1u << PERF_HIST_SUB_BITS)
+#define PERF_HIST_BUCKETS (2 * PERF_HIST_SUB_BUCKETS + (64 - PERF_HIST_SUB_BITS - 1) * PERF_HIST_SUB_BUCKETS)
+
+// 单个计数器的汇总 (时间单位为纳秒)
+typedef struct perf_stats_t {
+    const char* name;
+    uint64_t calls;
+    double total_ns;
+    double min_ns;
+    double mean_ns;
+    double p50_ns;
+    double p90_ns;
+    double p99_ns;
+    double max_ns;
+} perf_stats_t;
+
+uint64_t perf_now(void);                                  // 当前时间戳 (TSC或纳秒)
+void perf_record(perf_counter_t id, uint64_t elapsed);   // 记录一次调用
+void perf_reset(void);
+int perf_get_stats(perf_counter_t id, perf_stats_t* stats);
+void dump_perf_counters(void);
+
+#if KERNEL_PERF
+#define PERF_BEGIN() uint64_t perf_t0 = perf_now()
+#define PERF_END(id) perf_record((id), perf_now() - perf_t0)
+#else
+#define PERF_BEGIN() ((void)0)
+#define PERF_END(id) ((void)0)
+#endif
+
+#endif // _PERF_H
\ No newline at end of file
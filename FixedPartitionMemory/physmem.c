@@ -0,0 +1,139 @@
+#include "os_types.h"
+#include "config.h"
+#include "log.h"
+#include "kernel.h"
+#include "physmem.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#define HUGE_PAGE_SIZE (2u * 1024 * 1024)   // MAP_HUGETLB 的长度按默认大页 (2MB) 对齐
+
+// 映射状态位于当前内核上下文
+#define PHYSMEM (kernel_ctx_current()->mem)
+
+static size_t map_length(void) {
+    size_t len = PHYSMEM.size;
+    if (PHYSMEM.huge) {
+        len = (len + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+    return len;
+}
+
+int physmem_set_backing(const char* path, uint32_t flags) {
+#ifdef _WIN32
+    if (path) {
+        kernel_log(LOG_ERR, "Physical memory: file backing is not supported on this platform");
+        return -1;
+    }
+#endif
+    physmem_unmap();
+    PHYSMEM.path = path;
+    PHYSMEM.flags = flags;
+    return 0;
+}
+
+#ifdef _WIN32
+
+int physmem_map(void) {
+    if (PHYSMEM.base) return 0;
+    PHYSMEM.size = MEMORY_SIZE;
+    PHYSMEM.huge = 0;
+    // 提交的页面同样在首次访问时才分配
+    PHYSMEM.base = (uint8_t*)VirtualAlloc(NULL, PHYSMEM.size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!PHYSMEM.base) {
+        kernel_log(LOG_CRIT, "Physical memory: cannot allocate %lu bytes", (unsigned long)PHYSMEM.size);
+        return -1;
+    }
+    return 0;
+}
+
+void physmem_unmap(void) {
+    if (PHYSMEM.base) {
+        VirtualFree(PHYSMEM.base, 0, MEM_RELEASE);
+        PHYSMEM.base = NULL;
+    }
+}
+
+#else
+
+// 映射后备文件，文件不足MEMORY_SIZE时扩展 (新增部分读出为0)
+static void* map_file(const char* path, int extra) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    void* p;
+
+    if (fd < 0) return MAP_FAILED;
+    off_t end = lseek(fd, 0, SEEK_END);
+    if (end < (off_t)PHYSMEM.size && ftruncate(fd, PHYSMEM.size) != 0) {
+        close(fd);
+        return MAP_FAILED;
+    }
+    p = mmap(NULL, PHYSMEM.size, PROT_READ | PROT_WRITE, MAP_SHARED | extra, fd, 0);
+    close(fd);
+    return p;
+}
+
+int physmem_map(void) {
+    const char* backing = "anonymous";
+    int extra = 0;
+    void* p = MAP_FAILED;
+
+    if (PHYSMEM.base) return 0;
+    PHYSMEM.size = MEMORY_SIZE;
+    PHYSMEM.huge = 0;
+#ifdef MAP_POPULATE
+    if (PHYSMEM.flags & PHYSMEM_POPULATE) extra |= MAP_POPULATE;
+#endif
+
+    if (PHYSMEM.path) {
+        p = map_file(PHYSMEM.path, extra);
+        if (p == MAP_FAILED) {
+            kernel_log(LOG_ERR, "Physical memory: cannot map %s, using anonymous memory", PHYSMEM.path);
+        } else {
+            backing = PHYSMEM.path;
+        }
+    }
+#ifdef MAP_HUGETLB
+    if (p == MAP_FAILED && (PHYSMEM.flags & PHYSMEM_HUGE_PAGES)) {
+        PHYSMEM.huge = 1;
+        p = mmap(NULL, map_length(), PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | extra, -1, 0);
+        if (p == MAP_FAILED) {
+            PHYSMEM.huge = 0;
+            kernel_log(LOG_NOTICE, "Physical memory: no huge pages reserved, using normal pages");
+        }
+    }
+#endif
+    if (p == MAP_FAILED) {
+        p = mmap(NULL, PHYSMEM.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extra, -1, 0);
+    }
+    if (p == MAP_FAILED) {
+        kernel_log(LOG_CRIT, "Physical memory: cannot map %lu bytes", (unsigned long)PHYSMEM.size);
+        return -1;
+    }
+#ifdef MADV_HUGEPAGE
+    // 没有保留大页时退而请求透明大页
+    if ((PHYSMEM.flags & PHYSMEM_HUGE_PAGES) && !PHYSMEM.huge) {
+        madvise(p, PHYSMEM.size, MADV_HUGEPAGE);
+    }
+#endif
+
+    PHYSMEM.base = (uint8_t*)p;
+    kernel_log(LOG_INFO, "Physical memory: %lu bytes mapped (%s%s)", (unsigned long)PHYSMEM.size,
+        backing, PHYSMEM.huge ? ", huge pages" : "");
+    return 0;
+}
+
+void physmem_unmap(void) {
+    if (PHYSMEM.base) {
+        munmap(PHYSMEM.base, map_length());
+        PHYSMEM.base = NULL;
+    }
+}
+
+#endif
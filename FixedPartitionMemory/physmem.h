@@ -0,0 +1,25 @@
+#ifndef _PHYSMEM_H
+#define _PHYSMEM_H
+
+#include "os_types.h"
+
+// 模拟物理内存 (MEMORY_SIZE字节)
+// 用mmap映射：默认匿名映射，页面在首次访问时才分配，启动时不触碰整块内存；
+// 指定后备文件时映射该文件 (MAP_SHARED)，内容可在运行后查看或在下次运行时复用
+#define PHYSMEM_HUGE_PAGES 0x1   // 尝试大页 (MAP_HUGETLB，失败时退回普通页并建议透明大页)
+#define PHYSMEM_POPULATE   0x2   // 映射时预先填充所有页 (MAP_POPULATE)
+
+// 映射状态 (每个内核上下文一份)
+typedef struct physmem_t {
+    uint8_t* base;       // NULL表示尚未映射
+    uint32_t size;
+    uint32_t flags;      // PHYSMEM_*
+    const char* path;    // 后备文件，NULL为匿名映射 (由调用者保持有效)
+    int huge;            // 实际使用了MAP_HUGETLB
+} physmem_t;
+
+int physmem_set_backing(const char* path, uint32_t flags);   // 解除当前映射，下次访问时按新设置映射
+int physmem_map(void);                                       // 已映射时直接返回0
+void physmem_unmap(void);
+
+#endif // _PHYSMEM_H
@@ -2,18 +2,19 @@
 #include "log.h"
 #include "process.h"
 #include "config.h"
+#include "kernel.h"
 
 
-// ȷȫֱ
-process_t process_table[MAX_PROCESSES];
-static uint32_t next_pid = 1;
+// ̱λڵǰں (kernel.h)
+#define next_pid (kernel_ctx_current()->next_pid)
 
 void process_init(void) {
     uint32_t i;
     for (i = 0; i < MAX_PROCESSES; i++) {
         process_table[i].pid = 0;
         process_table[i].state = PROC_TERMINATED;
-        process_table[i].next = NULL;
+        process_table[i].next = PROC_NONE;
+        process_table[i].prev = PROC_NONE;
     }
     next_pid = 1;
     DEBUG_PRINT("Process table initialized");
@@ -24,31 +25,51 @@ process_t* create_process(uint32_t pid, const char* name, uint32_t memory_size,
     uint32_t i;
     uint32_t name_len;
     process_t* proc;
+    process_info_t* info;
 
     for (i = 0; i < MAX_PROCESSES; i++) {
         if (process_table[i].state == PROC_TERMINATED) {
             proc = &process_table[i];
-            proc->pid = (pid == 0) ? next_pid++ : pid;
-            if (next_pid > MAX_PROCESSES) next_pid = 1;
+            info = &process_info_table[i];
+            if (pid == 0) {
+                // PIDƺʹõPID (free_memoryPIDҷ)
+                do {
+                    pid = next_pid++;
+                    if (next_pid > MAX_PROCESSES) next_pid = 1;
+                } while (find_process_by_pid(pid));
+            }
+            proc->pid = pid;
 
             name_len = strlen(name);
             if (name_len > 15) name_len = 15;
-            memcpy(proc->name, name, name_len);
-            proc->name[name_len] = '\0';
+            memcpy(info->name, name, name_len);
+            info->name[name_len] = '\0';
 
             proc->state = PROC_CREATED;
             proc->memory_size = memory_size;
-            proc->memory_start = 0;
-            proc->memory_end = 0;
             proc->arrival_time = arrival_time;
-            proc->burst_time = burst_time;
             proc->remaining_time = burst_time;
             proc->priority = 3;
-            proc->io_requests = 0;
-            proc->next = NULL;
+            info->memory_start = 0;
+            info->memory_end = 0;
+            info->burst_time = burst_time;
+            info->start_time = PROC_TIME_NONE;
+            info->finish_time = PROC_TIME_NONE;
+            info->io_requests = 0;
+            info->io_issued = 0;
+            info->io_start = 0;
+            info->io_track = 0;
+            info->io_time = 0;
+            info->swapped = 0;
+            info->swap_time = arrival_time;
+            info->deadline = 0;
+            info->period = 0;
+            info->rt_util = 0;
+            proc->next = PROC_NONE;
+            proc->prev = PROC_NONE;
 
             DEBUG_PRINT("Process created: PID=%d, Name=%s, Memory=%d, Time=%d",
-                proc->pid, proc->name, proc->memory_size, proc->burst_time);
+                proc->pid, info->name, proc->memory_size, info->burst_time);
             return proc;
         }
     }
@@ -69,9 +90,10 @@ process_t* find_process_by_pid(uint32_t pid) {
 
 void terminate_process(process_t* proc) {
     if (proc && proc->state != PROC_TERMINATED) {
+        scheduler_remove_process(proc);
         proc->state = PROC_TERMINATED;
-        proc->memory_start = 0;
-        proc->memory_end = 0;
+        process_info(proc)->memory_start = 0;
+        process_info(proc)->memory_end = 0;
     }
 }
 
@@ -82,4 +104,65 @@ void process_set_state(process_t* proc, process_state_t new_state) {
 }
 
 void dump_process_info(process_t* proc) {
+}
+
+// ̶в (Ϊ̱±)
+static uint32_t slot_of(const process_t* proc) {
+    return (uint32_t)(proc - process_table);
+}
+
+void proc_queue_init(proc_queue_t* queue) {
+    queue->front = PROC_NONE;
+    queue->rear = PROC_NONE;
+    queue->count = 0;
+}
+
+void proc_queue_push(proc_queue_t* queue, process_t* proc) {
+    if (!proc) return;
+
+    uint32_t slot = slot_of(proc);
+    proc->next = PROC_NONE;
+    proc->prev = queue->rear;
+
+    if (queue->rear == PROC_NONE) {
+        // Ϊ
+        queue->front = slot;
+    } else {
+        // ӵĩβ
+        process_table[queue->rear].next = slot;
+    }
+    queue->rear = slot;
+    queue->count++;
+}
+
+void proc_queue_remove(proc_queue_t* queue, process_t* proc) {
+    if (proc->prev == PROC_NONE) {
+        queue->front = proc->next;
+    } else {
+        process_table[proc->prev].next = proc->next;
+    }
+    if (proc->next == PROC_NONE) {
+        queue->rear = proc->prev;
+    } else {
+        process_table[proc->next].prev = proc->prev;
+    }
+
+    proc->next = PROC_NONE;
+    proc->prev = PROC_NONE;
+    queue->count--;
+}
+
+process_t* proc_queue_pop(proc_queue_t* queue) {
+    if (queue->front == PROC_NONE) {
+        return NULL;
+    }
+
+    process_t* proc = &process_table[queue->front];
+    proc_queue_remove(queue, proc);
+    return proc;
+}
+
+// ֻжûǰȷϽڵĸ (״̬)
+BOOL proc_queue_contains(const proc_queue_t* queue, const process_t* proc) {
+    return proc->prev != PROC_NONE || queue->front == slot_of(proc);
 }
\ No newline at end of file
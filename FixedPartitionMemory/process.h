@@ -12,35 +12,58 @@ typedef enum {
     PROC_READY,      // 
     PROC_RUNNING,    // 
     PROC_WAITING,    // ȴ
+    PROC_SUSPENDED,  // ѻ (swap.h)
     PROC_TERMINATED  // ֹ
 } process_state_t;
 
-// ̽ṹ
+#define PROC_TIME_NONE 0xFFFFFFFFu
+#define PROC_NONE 0xFFFFFFFFu       //  (̱±)
+
+// ̽ṹ ()
+// ֻȡɨ衢PIDҺͷʱȡֶ (32ֽڣÿ)
+// ֶ process_info_t 
 typedef struct process_t {
     uint32_t pid;              // ID
-    char name[16];             // 
     process_state_t state;     // ״̬
-
-    // ڴ
     uint32_t memory_size;      // ҪڴС
-    uint32_t memory_start;     // ڴʼַ
-    uint32_t memory_end;       // ڴַ
-
-    // ִʱ
     uint32_t arrival_time;     // ʱ
-    uint32_t burst_time;       // ִʱ
     uint32_t remaining_time;   // ʣִʱ
-
-    // Ϣ
     uint32_t priority;         // ȼ
-    uint32_t io_requests;      // I/O
 
-    // ָ
-    struct process_t* next;
+    //  (л豸): ̱±꣬PROC_NONEʾ
+    uint32_t next;
+    uint32_t prev;
 } process_t;
 
-// ȫֱextern
-extern process_t process_table[MAX_PROCESSES];
+// ̵ݣ process_info(proc) 
+typedef struct process_info_t {
+    char name[16];             // 
+    uint32_t memory_start;     // ڴʼַ
+    uint32_t memory_end;       // ڴַ
+    uint32_t burst_time;       // ִʱ
+    uint32_t start_time;       // ״ʱ (PROC_TIME_NONEʾδ)
+    uint32_t finish_time;      // ʱ
+    uint32_t io_requests;      // ִڼ䷢I/O (ȷֲִʱ)
+    uint32_t io_issued;        // ѷI/O
+    uint32_t io_start;         // ǰI/Oķʱ
+    uint32_t io_track;         // ǰI/OʵĴŵ
+    uint32_t io_time;          // I/Oϵʱ
+    uint32_t swapped;          // 1ʾӳںļУռ
+    uint32_t swap_time;        // һλʱ
+    uint32_t deadline;         // Խֹʱ: ڵôʱ䵥λ (0ʾʵʱ)
+    uint32_t period;           //  (С0ʾdeadlineͬ)EDF׼
+    uint32_t rt_util;          // EDF׼ʱԤ (scheduler.h0ʾδԤ)
+} process_info_t;
+
+// ̶: process_t.next/prevӵ˫Ϊ̱±
+// ͬһʱһ (С豸л򽻻)
+typedef struct proc_queue_t {
+    uint32_t front;      // ǰ (PROC_NONEʾ)
+    uint32_t rear;       // к
+    uint32_t count;      // еĽ
+} proc_queue_t;
+
+// ̱ process_table ͬ±ݱ process_info_table λں (kernel.h)
 
 // ںAPI
 void process_init(void);
@@ -51,4 +74,11 @@ void terminate_process(process_t* proc);
 void process_set_state(process_t* proc, process_state_t new_state);
 void dump_process_info(process_t* proc);
 
+// ̶вΪO(1)
+void proc_queue_init(proc_queue_t* queue);
+void proc_queue_push(proc_queue_t* queue, process_t* proc);     // ӵβ
+process_t* proc_queue_pop(proc_queue_t* queue);                 // ȡףնзNULL
+void proc_queue_remove(proc_queue_t* queue, process_t* proc);   // λժ
+BOOL proc_queue_contains(const proc_queue_t* queue, const process_t* proc);
+
 #endif // _PROCESS_H
\ No newline at end of file
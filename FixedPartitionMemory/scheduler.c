@@ -4,55 +4,154 @@
 #include "config.h"
 #include "process.h"
 #include "memory.h"
+#include "kernel.h"
+#include "perf.h"
+#include "traffic.h"
+#include "io.h"
+#include "swap.h"
+#include "frag.h"
+#include "adapt.h"
 
 // 全局调度器
-scheduler_t g_scheduler;
 
-// 就绪队列操作
-static void ready_queue_init(ready_queue_t* queue) {
-    queue->front = NULL;
-    queue->rear = NULL;
-    queue->count = 0;
+// 下面的 *_as(type) 是按调度算法参数化的实现，强制内联：
+// 公共API以 g_scheduler.type 调用 (运行时分支)，scheduler_tick_for() 返回的特化版本以常量调用，
+// 编译器在每个特化中删去其他算法的分支
+#if defined(__GNUC__)
+#define SCHED_INLINE static inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define SCHED_INLINE static __forceinline
+#else
+#define SCHED_INLINE static inline
+#endif
+
+// 取出优先级最高的进程 (priority值越小优先级越高，同优先级按FIFO)
+static process_t* ready_queue_dequeue_priority(proc_queue_t* queue) {
+    if (queue->front == PROC_NONE) {
+        return NULL;
+    }
+
+    process_t* best = &process_table[queue->front];
+    for (uint32_t i = best->next; i != PROC_NONE; i = process_table[i].next) {
+        if (process_table[i].priority < best->priority) {
+            best = &process_table[i];
+        }
+    }
+
+    proc_queue_remove(queue, best);
+    return best;
 }
 
-static void ready_queue_enqueue(ready_queue_t* queue, process_t* proc) {
-    if (!proc) return;
+// 当前进程是否仍在运行
+static BOOL current_is_running(void) {
+    return g_scheduler.current_process &&
+           g_scheduler.current_process->state == PROC_RUNNING;
+}
+
+// EDF就绪堆 (见scheduler.h)
+static uint32_t edf_deadline(const process_t* proc) {
+    return rt_absolute_deadline(proc->arrival_time, process_info(proc)->deadline);
+}
 
-    proc->next = NULL;
+static void heap_place(deadline_heap_t* h, uint32_t i, uint64_t key, uint32_t slot) {
+    h->key[i] = key;
+    h->slot[i] = slot;
+    h->pos[slot] = i;
+}
 
-    if (queue->rear == NULL) {
-        // 队列为空
-        queue->front = proc;
-        queue->rear = proc;
-    } else {
-        // 添加到队列末尾
-        queue->rear->next = proc;
-        queue->rear = proc;
+static void heap_sift_up(deadline_heap_t* h, uint32_t i, uint64_t key, uint32_t slot) {
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (h->key[parent] <= key) break;
+        heap_place(h, i, h->key[parent], h->slot[parent]);
+        i = parent;
     }
-    queue->count++;
+    heap_place(h, i, key, slot);
 }
 
-static process_t* ready_queue_dequeue(ready_queue_t* queue) {
-    if (queue->front == NULL) {
-        return NULL;
+static void heap_sift_down(deadline_heap_t* h, uint32_t i, uint64_t key, uint32_t slot) {
+    for (;;) {
+        uint32_t child = 2 * i + 1;
+        if (child >= h->count) break;
+        if (child + 1 < h->count && h->key[child + 1] < h->key[child]) child++;
+        if (h->key[child] >= key) break;
+        heap_place(h, i, h->key[child], h->slot[child]);
+        i = child;
     }
+    heap_place(h, i, key, slot);
+}
+
+static void heap_push(deadline_heap_t* h, process_t* proc) {
+    uint64_t key = ((uint64_t)edf_deadline(proc) << 32) | h->seq++;
+    heap_sift_up(h, h->count++, key, (uint32_t)(proc - process_table));
+}
 
-    process_t* proc = queue->front;
-    queue->front = proc->next;
+// 取出堆中第i个进程
+static process_t* heap_remove_at(deadline_heap_t* h, uint32_t i) {
+    uint32_t idx = h->slot[i];
+    uint64_t last = h->key[--h->count];
+    uint32_t last_slot = h->slot[h->count];
 
-    if (queue->front == NULL) {
-        // 队列变空
-        queue->rear = NULL;
+    h->pos[idx] = PROC_NONE;
+    if (i < h->count) {
+        if (i > 0 && last < h->key[(i - 1) / 2]) heap_sift_up(h, i, last, last_slot);
+        else heap_sift_down(h, i, last, last_slot);
     }
-    
-    proc->next = NULL;
-    queue->count--;
-    return proc;
+    return &process_table[idx];
+}
+
+// 加入就绪队列 (EDF下为就绪堆)
+static void ready_push(scheduler_type_t type, process_t* proc) {
+    if (type == SCHED_EDF) heap_push(&g_scheduler.edf, proc);
+    else proc_queue_push(&g_scheduler.ready_queue, proc);
+}
+
+// 实时进程的利用率 (超过1的按 RT_UTIL_SCALE + 1 计，永远不能准入)
+static uint32_t rt_demand(const process_t* proc) {
+    const process_info_t* info = process_info(proc);
+    uint32_t period = info->period ? info->period : info->deadline;
+    uint64_t util;
+
+    if (!info->deadline) return 0;
+    util = ((uint64_t)info->burst_time * RT_UTIL_SCALE + period - 1) / period;
+    return util > RT_UTIL_SCALE ? RT_UTIL_SCALE + 1 : (uint32_t)util;
+}
+
+static void rt_release(process_t* proc) {
+    process_info_t* info = process_info(proc);
+    g_scheduler.rt_util -= info->rt_util;
+    info->rt_util = 0;
+}
+
+// 进程完成: 统计截止时间 (完成时间为该时间单位结束时) 并释放预留的利用率
+static void rt_complete(process_t* proc) {
+    const process_info_t* info = process_info(proc);
+    rt_stats_t* rt = &g_scheduler.rt;
+
+    if (info->deadline) {
+        int64_t lateness = (int64_t)info->finish_time + 1 - rt_absolute_deadline(proc->arrival_time, info->deadline);
+        if (lateness > 0) rt->misses++;
+        if (rt->completed == 0 || lateness > rt->max_lateness) rt->max_lateness = (int32_t)lateness;
+        rt->lateness_sum += lateness;
+        rt->completed++;
+    }
+    rt_release(proc);
 }
 
-// 调度器初始化
+// 调度器初始化 (丢弃原就绪队列，设备队列和交换队列不变；已预留的实时利用率保留)
 void scheduler_init(scheduler_type_t type) {
-    ready_queue_init(&g_scheduler.ready_queue);
+    g_scheduler.rt_util = 0;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        g_scheduler.edf.pos[i] = PROC_NONE;
+        if (process_table[i].state != PROC_TERMINATED) g_scheduler.rt_util += process_info_table[i].rt_util;
+        if (process_table[i].state == PROC_WAITING || process_table[i].state == PROC_SUSPENDED) continue;
+        process_table[i].next = PROC_NONE;
+        process_table[i].prev = PROC_NONE;
+    }
+    g_scheduler.edf.count = 0;
+    g_scheduler.edf.seq = 0;
+    memset(&g_scheduler.rt, 0, sizeof(rt_stats_t));
+    proc_queue_init(&g_scheduler.ready_queue);
     g_scheduler.current_process = NULL;
     g_scheduler.type = type;
     g_scheduler.time_slice = TIME_SLICE;  // 从config.h获取
@@ -66,19 +165,84 @@ void scheduler_add_process(process_t* proc) {
     if (!proc) return;
     
     process_set_state(proc, PROC_READY);
-    ready_queue_enqueue(&g_scheduler.ready_queue, proc);
+    ready_push(g_scheduler.type, proc);
     
     DEBUG_PRINT("Process %d added to ready queue", proc->pid);
 }
 
+void scheduler_ready_remove(process_t* proc) {
+    if (g_scheduler.type == SCHED_EDF) {
+        uint32_t i = g_scheduler.edf.pos[proc - process_table];
+        if (i != PROC_NONE) heap_remove_at(&g_scheduler.edf, i);
+    } else if (proc_queue_contains(&g_scheduler.ready_queue, proc)) {
+        proc_queue_remove(&g_scheduler.ready_queue, proc);
+    }
+}
+
+uint32_t scheduler_ready_count(void) {
+    return g_scheduler.ready_queue.count + g_scheduler.edf.count;
+}
+
+sched_admit_t scheduler_admit(process_t* proc) {
+    process_info_t* info = process_info(proc);
+    uint32_t demand;
+
+    if (g_scheduler.type != SCHED_EDF) return SCHED_ADMIT_OK;
+    demand = info->rt_util ? 0 : rt_demand(proc);
+    if (demand && g_scheduler.rt_util + demand > RT_UTIL_SCALE) {
+        g_scheduler.rt.rejected_cpu++;
+        DEBUG_PRINT("EDF: process %d rejected, utilization %u + %u", proc->pid, g_scheduler.rt_util, demand);
+        return SCHED_ADMIT_CPU;
+    }
+    if (!find_free_partition(proc->memory_size)) {
+        // 与分配失败一样计入碎片统计和自适应分区的请求直方图
+        frag_on_failure(proc->memory_size);
+        adapt_record_request(proc->memory_size, 0);
+        if (info->deadline) g_scheduler.rt.memory_waits++;
+        return SCHED_ADMIT_MEMORY;
+    }
+    if (demand) {
+        info->rt_util = demand;
+        g_scheduler.rt_util += demand;
+        g_scheduler.rt.admitted++;
+    }
+    return SCHED_ADMIT_OK;
+}
+
+void scheduler_get_rt_stats(rt_stats_t* stats) {
+    *stats = g_scheduler.rt;
+}
+
+// 进程被终止时调用: 移出就绪队列、设备队列或交换队列，正在运行的进程放弃CPU
+void scheduler_remove_process(process_t* proc) {
+    if (!proc) return;
+
+    if (proc->state == PROC_WAITING) {
+        io_cancel(proc);
+        swap_cancel(proc);
+    } else if (proc->state == PROC_SUSPENDED) {
+        swap_cancel(proc);
+    } else if (proc->state == PROC_READY) {
+        scheduler_ready_remove(proc);
+        DEBUG_PRINT("Process %d removed from ready queue", proc->pid);
+    }
+    if (g_scheduler.current_process == proc) {
+        g_scheduler.current_process = NULL;
+    }
+    rt_release(proc);
+}
+
 // 获取下一个要调度的进程
-process_t* scheduler_get_next_process(void) {
+SCHED_INLINE process_t* get_next_as(scheduler_type_t type) {
+    PERF_BEGIN();
     process_t* next_proc = NULL;
     
-    switch (g_scheduler.type) {
+    switch (type) {
         case SCHED_FIFO:
-            // FIFO: 按照就绪队列顺序
-            next_proc = ready_queue_dequeue(&g_scheduler.ready_queue);
+            // FIFO: 按照就绪队列顺序，不抢占正在运行的进程
+            if (!current_is_running()) {
+                next_proc = proc_queue_pop(&g_scheduler.ready_queue);
+            }
             break;
             
         case SCHED_RR:
@@ -88,53 +252,80 @@ process_t* scheduler_get_next_process(void) {
                 // 如果当前进程时间片用完，放回队列末尾
                 if (g_scheduler.current_time_slice == 0) {
                     process_set_state(g_scheduler.current_process, PROC_READY);
-                    ready_queue_enqueue(&g_scheduler.ready_queue, g_scheduler.current_process);
+                    proc_queue_push(&g_scheduler.ready_queue, g_scheduler.current_process);
                     g_scheduler.current_process = NULL;
                 }
             }
             
             if (!g_scheduler.current_process) {
-                next_proc = ready_queue_dequeue(&g_scheduler.ready_queue);
+                next_proc = proc_queue_pop(&g_scheduler.ready_queue);
             }
             break;
             
         case SCHED_PRIORITY:
-            // 优先级调度: 这里简化实现，取队列中的进程
-            next_proc = ready_queue_dequeue(&g_scheduler.ready_queue);
+            // 非抢占式优先级调度: 当前进程结束后取优先级最高的进程
+            if (!current_is_running()) {
+                next_proc = ready_queue_dequeue_priority(&g_scheduler.ready_queue);
+            }
+            break;
+
+        case SCHED_EDF:
+            // 抢占式EDF: 取绝对截止时间最早的进程，严格早于当前进程的截止时间时才抢占
+            if (!current_is_running()) {
+                if (g_scheduler.edf.count) next_proc = heap_remove_at(&g_scheduler.edf, 0);
+            } else if (g_scheduler.edf.count &&
+                (uint32_t)(g_scheduler.edf.key[0] >> 32) < edf_deadline(g_scheduler.current_process)) {
+                process_t* preempted = g_scheduler.current_process;
+                next_proc = heap_remove_at(&g_scheduler.edf, 0);
+                process_set_state(preempted, PROC_READY);
+                heap_push(&g_scheduler.edf, preempted);
+                g_scheduler.current_process = NULL;
+                g_scheduler.rt.preemptions++;
+            }
             break;
             
         default:
-            next_proc = ready_queue_dequeue(&g_scheduler.ready_queue);
+            next_proc = proc_queue_pop(&g_scheduler.ready_queue);
             break;
     }
     
+    PERF_END(PERF_SCHED_GET_NEXT);
     return next_proc;
 }
 
+process_t* scheduler_get_next_process(void) {
+    return get_next_as(g_scheduler.type);
+}
+
 // 执行调度
-void scheduler_schedule(void) {
+SCHED_INLINE void schedule_as(scheduler_type_t type) {
     // 获取下一个进程
-    process_t* next_proc = scheduler_get_next_process();
+    process_t* next_proc = get_next_as(type);
     
     if (next_proc) {
         // 设置当前进程
         g_scheduler.current_process = next_proc;
         process_set_state(next_proc, PROC_RUNNING);
         g_scheduler.current_time_slice = g_scheduler.time_slice;
+        if (process_info(next_proc)->start_time == PROC_TIME_NONE) {
+            process_info(next_proc)->start_time = get_current_time();
+        }
         
         DEBUG_PRINT("Scheduled process %d to run", next_proc->pid);
     } else if (g_scheduler.current_process) {
-        // 如果没有新进程但当前进程还在运行，继续运行
-        if (g_scheduler.current_process->state == PROC_RUNNING) {
-            g_scheduler.current_time_slice = g_scheduler.time_slice;
-        } else {
+        // 如果没有新进程但当前进程还在运行，继续使用剩余的时间片
+        if (g_scheduler.current_process->state != PROC_RUNNING) {
             g_scheduler.current_process = NULL;
         }
     }
 }
 
+void scheduler_schedule(void) {
+    schedule_as(g_scheduler.type);
+}
+
 // 执行当前进程
-void scheduler_run_current_process(void) {
+SCHED_INLINE void run_current_as(scheduler_type_t type) {
     if (!g_scheduler.current_process) {
         return;
     }
@@ -149,8 +340,11 @@ void scheduler_run_current_process(void) {
     
     // 执行一个时间单位
     if (current->remaining_time > 0) {
+        traffic_run(current);
         current->remaining_time--;
-        g_scheduler.current_time_slice--;
+        if (g_scheduler.current_time_slice > 0) {
+            g_scheduler.current_time_slice--;
+        }
         
         DEBUG_PRINT("Process %d executed, remaining time: %d", 
                    current->pid, current->remaining_time);
@@ -158,29 +352,81 @@ void scheduler_run_current_process(void) {
         // 检查是否完成
         if (current->remaining_time == 0) {
             DEBUG_PRINT("Process %d completed at time slice", current->pid);
+            process_info(current)->finish_time = get_current_time();
+            rt_complete(current);
             free_memory(current);
             process_set_state(current, PROC_TERMINATED);
             g_scheduler.current_process = NULL;
-        } else if (g_scheduler.current_time_slice == 0 && g_scheduler.type == SCHED_RR) {
+        } else if (io_check_block(current)) {
+            // 发出I/O请求，阻塞到设备完成
+            g_scheduler.current_process = NULL;
+        } else if (g_scheduler.current_time_slice == 0 && type == SCHED_RR) {
             // 时间片用完，放回就绪队列
             process_set_state(current, PROC_READY);
-            ready_queue_enqueue(&g_scheduler.ready_queue, current);
+            proc_queue_push(&g_scheduler.ready_queue, current);
             g_scheduler.current_process = NULL;
             DEBUG_PRINT("Time slice expired for process %d", current->pid);
         }
     }
 }
 
+void scheduler_run_current_process(void) {
+    run_current_as(g_scheduler.type);
+}
+
+// 一个时间单位的调度和执行，调度算法为编译期常量
+#define SCHEDULER_TICK(name, type) \
+    static process_t* scheduler_tick_##name(void) { \
+        schedule_as(type); \
+        process_t* running = g_scheduler.current_process; \
+        run_current_as(type); \
+        return running; \
+    }
+
+SCHEDULER_TICK(fifo, SCHED_FIFO)
+SCHEDULER_TICK(rr, SCHED_RR)
+SCHEDULER_TICK(priority, SCHED_PRIORITY)
+SCHEDULER_TICK(edf, SCHED_EDF)
+
+// 未知的算法类型按运行时分支处理
+static process_t* scheduler_tick_dynamic(void) {
+    scheduler_schedule();
+    process_t* running = g_scheduler.current_process;
+    scheduler_run_current_process();
+    return running;
+}
+
+scheduler_tick_fn_t scheduler_tick_for(scheduler_type_t type) {
+    switch (type) {
+        case SCHED_FIFO: return scheduler_tick_fifo;
+        case SCHED_RR: return scheduler_tick_rr;
+        case SCHED_PRIORITY: return scheduler_tick_priority;
+        case SCHED_EDF: return scheduler_tick_edf;
+        default: return scheduler_tick_dynamic;
+    }
+}
+
 // 显示调度器状态
 void scheduler_dump_status(void) {
     kernel_log(LOG_INFO, "Scheduler Status:");
     kernel_log(LOG_INFO, "  Type: %s", 
               g_scheduler.type == SCHED_FIFO ? "FIFO" :
-              g_scheduler.type == SCHED_RR ? "Round Robin" : "Priority");
-    kernel_log(LOG_INFO, "  Ready Queue Count: %d", g_scheduler.ready_queue.count);
+              g_scheduler.type == SCHED_RR ? "Round Robin" :
+              g_scheduler.type == SCHED_EDF ? "EDF" : "Priority");
+    kernel_log(LOG_INFO, "  Ready Queue Count: %d", scheduler_ready_count());
+    if (g_scheduler.type == SCHED_EDF) {
+        kernel_log(LOG_INFO, "  Real-time Utilization: %u/%u, %u admitted, %u rejected",
+                  g_scheduler.rt_util, RT_UTIL_SCALE,
+                  (uint32_t)g_scheduler.rt.admitted, (uint32_t)g_scheduler.rt.rejected_cpu);
+    }
+    if (g_scheduler.rt.completed) {
+        kernel_log(LOG_INFO, "  Deadlines: %u/%u missed, max lateness %d",
+                  (uint32_t)g_scheduler.rt.misses, (uint32_t)g_scheduler.rt.completed,
+                  g_scheduler.rt.max_lateness);
+    }
     kernel_log(LOG_INFO, "  Current Process: %s", 
               g_scheduler.current_process ? 
-              g_scheduler.current_process->name : "None");
+              process_info(g_scheduler.current_process)->name : "None");
     kernel_log(LOG_INFO, "  Time Slice: %d/%d", 
               g_scheduler.current_time_slice, g_scheduler.time_slice);
 }
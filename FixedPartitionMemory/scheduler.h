@@ -2,41 +2,94 @@
 #define _SCHEDULER_H
 
 #include "os_types.h"
+#include "config.h"
 #include "process.h"
 
 // 调度算法类型
 typedef enum {
     SCHED_FIFO,      // 先进先出
     SCHED_RR,        // 时间片轮转
-    SCHED_PRIORITY   // 优先级调度
+    SCHED_PRIORITY,  // 优先级调度
+    SCHED_EDF        // 最早截止时间优先 (抢占式，带准入控制)
 } scheduler_type_t;
 
-// 就绪队列结构
-typedef struct ready_queue_t {
-    process_t* front;    // 队列前端
-    process_t* rear;     // 队列后端
-    uint32_t count;      // 队列中的进程数量
-} ready_queue_t;
+// 实时进程: process_info_t.deadline 非0的进程，须在到达后deadline个时间单位内完成。
+// 其CPU利用率为 执行时间 / 周期 (周期为0时取deadline)，以 RT_UTIL_SCALE 为1
+#define RT_UTIL_SCALE 1000000u
+
+// EDF就绪堆: 以绝对截止时间为键的最小堆 (EDF下就绪进程在堆中，不在ready_queue中)
+// 键的高32位为绝对截止时间 (没有截止时间的进程为PROC_TIME_NONE，排在最后)，低32位为入堆序号，
+// 截止时间相同的进程按入堆先后 (FIFO) 运行
+typedef struct deadline_heap_t {
+    uint32_t count;
+    uint32_t seq;                   // 下一个入堆序号
+    uint64_t key[MAX_PROCESSES];
+    uint32_t slot[MAX_PROCESSES];   // 按堆中位置: 进程表下标
+    uint32_t pos[MAX_PROCESSES];    // 按进程表下标: 在堆中的位置，PROC_NONE表示不在堆中
+} deadline_heap_t;
+
+// 实时进程统计 (截止时间统计对所有调度算法有效，准入统计只在EDF下)
+typedef struct rt_stats_t {
+    uint64_t admitted;         // 通过准入并预留利用率的实时进程
+    uint64_t rejected_cpu;     // 利用率之和将超过1而被拒绝的次数
+    uint64_t memory_waits;     // 利用率允许但没有能容纳它的空闲分区的次数
+    uint64_t preemptions;      // 截止时间更早的进程抢占CPU的次数
+    uint64_t completed;        // 完成的实时进程
+    uint64_t misses;           // 其中完成时已过截止时间的
+    int64_t lateness_sum;      // (完成时间 - 截止时间) 之和，提前完成为负
+    int32_t max_lateness;
+} rt_stats_t;
+
+// EDF准入结果
+typedef enum {
+    SCHED_ADMIT_OK,            // 可以分配内存并加入就绪队列 (实时进程的利用率已预留)
+    SCHED_ADMIT_CPU,           // 利用率不足，应拒绝该进程
+    SCHED_ADMIT_MEMORY         // 暂时没有能容纳它的空闲分区，稍后重试
+} sched_admit_t;
 
 // 调度器状态
 typedef struct scheduler_t {
-    ready_queue_t ready_queue;
+    proc_queue_t ready_queue;    // 就绪队列 (进程状态为PROC_READY)
     process_t* current_process;  // 当前运行的进程
     scheduler_type_t type;       // 调度算法类型
     uint32_t time_slice;         // 时间片大小
     uint32_t current_time_slice; // 当前时间片剩余
+    deadline_heap_t edf;         // EDF就绪堆
+    uint32_t rt_util;            // 已准入、未结束的实时进程的利用率之和
+    rt_stats_t rt;
 } scheduler_t;
 
+// 绝对截止时间 (deadline为0时为PROC_TIME_NONE)
+static inline uint32_t rt_absolute_deadline(uint32_t arrival, uint32_t deadline) {
+    uint64_t t = (uint64_t)arrival + deadline;
+    if (!deadline) return PROC_TIME_NONE;
+    return t < PROC_TIME_NONE ? (uint32_t)t : PROC_TIME_NONE - 1;
+}
+
 // 调度器API
 void scheduler_init(scheduler_type_t type);
 void scheduler_add_process(process_t* proc);
+void scheduler_remove_process(process_t* proc);   // 移出就绪/设备队列并放弃CPU，O(1) (EDF下O(log n))
+void scheduler_ready_remove(process_t* proc);     // 把就绪进程移出就绪队列或EDF就绪堆
+uint32_t scheduler_ready_count(void);
+// EDF准入检查 (其他算法总是通过)，在为新进程分配内存之前调用:
+// 实时进程的利用率加上已准入的不超过1，且 find_free_partition() 能找到容纳它的空闲分区
+// (不为它换出进程或合并分区，没有空闲分区与分配失败一样计入碎片统计)。
+// 通过时为实时进程预留利用率 (重复调用不重复预留)，进程完成或终止时释放
+sched_admit_t scheduler_admit(process_t* proc);
+void scheduler_get_rt_stats(rt_stats_t* stats);
 process_t* scheduler_get_next_process(void);
 void scheduler_schedule(void);
 void scheduler_run_current_process(void);
 void scheduler_dump_status(void);
 
-// 全局调度器变量声明
-extern scheduler_t g_scheduler;
+// 调度并执行一个时间单位，返回本时间单位执行的进程 (无则NULL)
+// 等价于 scheduler_schedule() + scheduler_run_current_process()，但调度算法在编译期确定，
+// 每个算法一个特化版本，热循环中不再按 g_scheduler.type 分支。type 必须与 scheduler_init() 的一致
+typedef process_t* (*scheduler_tick_fn_t)(void);
+scheduler_tick_fn_t scheduler_tick_for(scheduler_type_t type);
+
+// 调度器状态 g_scheduler 位于内核上下文 (见kernel.h)
 
 // 时间片轮转调度相关函数
 void rr_scheduler_init(void);
@@ -0,0 +1,406 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "os_types.h"
+#include "config.h"
+#include "kernel.h"
+#include "scheduler.h"
+#include "frag.h"
+#include "adapt.h"
+#include "sim.h"
+
+#define SLOT_EMPTY 0xFFFFFFFFu
+
+static uint32_t rng_next(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint32_t rng_range(uint32_t* state, uint32_t lo, uint32_t hi) {
+    return hi > lo ? lo + rng_next(state) % (hi - lo + 1) : lo;
+}
+
+void trace_default_params(trace_params_t* params) {
+    params->count = 1000;
+    params->seed = 1;
+    params->min_memory = 16;
+    params->max_memory = 128;
+    params->min_burst = 1;
+    params->max_burst = 10;
+    params->max_interarrival = 12;
+    params->phase_length = 0;
+    params->alt_min_memory = 96;
+    params->alt_max_memory = 256;
+    params->max_io_requests = 0;
+    params->rt_percent = 0;
+    params->rt_max_slack = 4;
+}
+
+int trace_generate(trace_t* trace, const trace_params_t* params) {
+    uint32_t state = params->seed ? params->seed : 1;
+    uint32_t arrival = 0;
+
+    trace->entries = (trace_entry_t*)malloc(sizeof(trace_entry_t) * (params->count ? params->count : 1));
+    if (!trace->entries) return -1;
+    trace->count = params->count;
+
+    for (uint32_t i = 0; i < params->count; i++) {
+        trace_entry_t* e = &trace->entries[i];
+        e->arrival_time = arrival;
+        int alt = params->phase_length && (i / params->phase_length) % 2;
+        e->memory_size = alt ? rng_range(&state, params->alt_min_memory, params->alt_max_memory)
+                             : rng_range(&state, params->min_memory, params->max_memory);
+        e->burst_time = rng_range(&state, params->min_burst, params->max_burst);
+        e->priority = rng_range(&state, 1, 5);
+        arrival += rng_range(&state, 0, params->max_interarrival);
+        if (params->max_io_requests) {
+            // 每执行一个时间单位至多发出一个请求
+            uint32_t max_io = e->burst_time > 1 ? e->burst_time - 1 : 0;
+            if (max_io > params->max_io_requests) max_io = params->max_io_requests;
+            e->io_requests = rng_range(&state, 0, max_io);
+        } else {
+            e->io_requests = 0;
+        }
+        e->deadline = 0;
+        e->period = 0;
+        if (params->rt_percent && rng_range(&state, 1, 100) <= params->rt_percent) {
+            uint32_t slack = params->rt_max_slack > 2 ? params->rt_max_slack : 2;
+            e->deadline = e->burst_time * rng_range(&state, 2, slack);
+            e->period = e->deadline;
+        }
+    }
+    return 0;
+}
+
+static int cmp_arrival(const void* a, const void* b) {
+    const trace_entry_t* x = (const trace_entry_t*)a;
+    const trace_entry_t* y = (const trace_entry_t*)b;
+    if (x->arrival_time != y->arrival_time) return x->arrival_time < y->arrival_time ? -1 : 1;
+    return x < y ? -1 : (x > y);
+}
+
+// 文本格式: 每行 "到达时间 内存大小 执行时间 [优先级 [I/O请求数 [截止时间 [周期]]]]"，'#'开头为注释
+int trace_load(trace_t* trace, const char* path) {
+    FILE* f = fopen(path, "r");
+    char line[256];
+    uint32_t cap = 256;
+
+    if (!f) return -1;
+    trace->count = 0;
+    trace->entries = (trace_entry_t*)malloc(sizeof(trace_entry_t) * cap);
+    if (!trace->entries) {
+        fclose(f);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), f)) {
+        trace_entry_t e;
+        e.priority = 3;
+        e.io_requests = 0;
+        e.deadline = 0;
+        e.period = 0;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%u %u %u %u %u %u %u", &e.arrival_time, &e.memory_size,
+                &e.burst_time, &e.priority, &e.io_requests, &e.deadline, &e.period) < 3) {
+            continue;
+        }
+        if (trace->count == cap) {
+            trace_entry_t* grown = (trace_entry_t*)realloc(trace->entries, sizeof(trace_entry_t) * cap * 2);
+            if (!grown) {
+                fclose(f);
+                trace_free(trace);
+                return -1;
+            }
+            trace->entries = grown;
+            cap *= 2;
+        }
+        trace->entries[trace->count++] = e;
+    }
+    fclose(f);
+
+    qsort(trace->entries, trace->count, sizeof(trace_entry_t), cmp_arrival);
+    return 0;
+}
+
+int trace_save(const trace_t* trace, const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return -1;
+
+    fprintf(f, "# arrival memory burst priority io_requests deadline period\n");
+    for (uint32_t i = 0; i < trace->count; i++) {
+        const trace_entry_t* e = &trace->entries[i];
+        fprintf(f, "%u %u %u %u %u %u %u\n", e->arrival_time, e->memory_size, e->burst_time, e->priority,
+            e->io_requests, e->deadline, e->period);
+    }
+    fclose(f);
+    return 0;
+}
+
+void trace_free(trace_t* trace) {
+    free(trace->entries);
+    trace->entries = NULL;
+    trace->count = 0;
+}
+
+const char* sim_strategy_name(allocation_strategy_t strategy) {
+    switch (strategy) {
+        case FIRST_FIT: return "first-fit";
+        case BEST_FIT: return "best-fit";
+        case WORST_FIT: return "worst-fit";
+        default: return "unknown";
+    }
+}
+
+const char* sim_scheduler_name(scheduler_type_t type) {
+    switch (type) {
+        case SCHED_FIFO: return "fifo";
+        case SCHED_RR: return "rr";
+        case SCHED_PRIORITY: return "priority";
+        case SCHED_EDF: return "edf";
+        default: return "unknown";
+    }
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// 采样当前内存占用
+static void take_sample(sim_result_t* result, uint32_t now) {
+    sim_sample_t* s = &result->samples[result->sample_count++];
+    frag_stats_t fs;
+
+    frag_get_stats(&fs);
+    s->time = now;
+    s->allocated_bytes = fs.allocated_current;
+    s->requested_bytes = fs.allocated_current - fs.waste_current;
+    s->ready_count = scheduler_ready_count();
+}
+
+// 汇总完成进程的时间指标和利用率
+static void summarize(sim_result_t* result, const trace_t* trace) {
+    uint32_t count = trace->count;
+    uint32_t* turnarounds = (uint32_t*)malloc(sizeof(uint32_t) * (count ? count : 1));
+    double turn = 0, wait = 0, resp = 0, admit = 0, hold = 0;
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        sim_proc_result_t* p = &result->procs[i];
+        if (p->status != SIM_PROC_COMPLETED) continue;
+        turn += p->turnaround;
+        wait += p->waiting;
+        resp += p->response;
+        admit += p->admit_time - trace->entries[i].arrival_time;
+        hold += p->finish_time + 1 - p->admit_time;
+        if (turnarounds) turnarounds[n] = p->turnaround;
+        n++;
+    }
+    if (n) {
+        result->avg_turnaround = turn / n;
+        result->avg_waiting = wait / n;
+        result->avg_response = resp / n;
+        result->avg_admit_delay = admit / n;
+        result->avg_hold = hold / n;
+        if (turnarounds) {
+            qsort(turnarounds, n, sizeof(uint32_t), cmp_u32);
+            result->p95_turnaround = turnarounds[(uint32_t)(n * 0.95 + 0.999999) - 1];
+        }
+    }
+    free(turnarounds);
+
+    // 实时进程: 完成晚于截止时间或结束时已过截止时间仍未完成的都算错过
+    double lateness = 0, memory_wait = 0;
+    uint32_t late_n = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const trace_entry_t* e = &trace->entries[i];
+        sim_proc_result_t* p = &result->procs[i];
+        int missed = 0;
+        if (!e->deadline) continue;
+        result->rt_tasks++;
+        memory_wait += p->memory_waits;
+        if (p->memory_waits) result->rt_waited++;
+        if (p->status == SIM_PROC_COMPLETED) {
+            p->lateness = (int32_t)((int64_t)p->turnaround - e->deadline);
+            if (late_n == 0 || p->lateness > result->rt_max_lateness) result->rt_max_lateness = p->lateness;
+            lateness += p->lateness;
+            late_n++;
+            missed = p->lateness > 0;
+        } else if (p->status == SIM_PROC_UNFINISHED) {
+            missed = (uint64_t)e->arrival_time + e->deadline < result->ticks;
+        }
+        if (missed) {
+            result->rt_misses++;
+            if (p->memory_waits) result->rt_misses_waited++;
+        }
+    }
+    if (late_n) result->rt_mean_lateness = lateness / late_n;
+    if (result->rt_tasks) result->rt_avg_memory_wait = memory_wait / result->rt_tasks;
+
+    if (result->sample_count && result->user_memory) {
+        double alloc = 0, req = 0;
+        for (uint32_t i = 0; i < result->sample_count; i++) {
+            double a = (double)result->samples[i].allocated_bytes / result->user_memory;
+            alloc += a;
+            req += (double)result->samples[i].requested_bytes / result->user_memory;
+            if (a > result->peak_alloc_util) result->peak_alloc_util = a;
+        }
+        result->mean_alloc_util = alloc / result->sample_count;
+        result->mean_req_util = req / result->sample_count;
+    }
+}
+
+int sim_run(const trace_t* trace, const sim_config_t* config, sim_result_t* result) {
+    uint32_t* slot_entry;   // 进程表槽位 -> 轨迹下标
+    uint32_t interval = config->sample_interval ? config->sample_interval : 1;
+    uint32_t largest = 0;
+    uint32_t next = 0;
+    uint32_t done = 0;
+    char name[16];
+
+    memset(result, 0, sizeof(*result));
+    result->procs = (sim_proc_result_t*)calloc(trace->count ? trace->count : 1, sizeof(sim_proc_result_t));
+    result->samples = (sim_sample_t*)malloc(sizeof(sim_sample_t) * (config->max_ticks / interval + 1));
+    slot_entry = (uint32_t*)malloc(sizeof(uint32_t) * MAX_PROCESSES);
+    if (!result->procs || !result->samples || !slot_entry) {
+        free(slot_entry);
+        sim_result_free(result);
+        return -1;
+    }
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        slot_entry[i] = SLOT_EMPTY;
+    }
+
+    adapt_set_enabled(config->adaptive);
+    traffic_set_pattern(config->traffic, config->traffic_accesses, config->traffic_stride);
+    io_set_service_time(config->io_service_time);
+    io_set_scheduler(config->io_sched);
+    swap_set_enabled(config->swap);
+    swap_set_policy(config->reclaim);
+    kernel_init();
+    scheduler_init(config->scheduler);
+    scheduler_tick_fn_t tick = scheduler_tick_for(config->scheduler);
+    current_strategy = config->strategy;
+
+    for (uint32_t i = 1; i < partition_count; i++) {
+        result->user_memory += partition_table[i].size;
+        if (partition_table[i].size > largest) largest = partition_table[i].size;
+    }
+    // 自适应模式下分区可以合并，只拒绝超过全部用户内存的进程
+    if (config->adaptive) largest = result->user_memory;
+
+    while (done < trace->count && result->ticks < config->max_ticks) {
+        uint32_t now = get_current_time();
+
+        // 到达: 进程表满时留在轨迹中，下个时间单位再试
+        while (next < trace->count && trace->entries[next].arrival_time <= now) {
+            const trace_entry_t* e = &trace->entries[next];
+            snprintf(name, sizeof(name), "t%u", next);
+            process_t* proc = create_process(next + 1, name, e->memory_size, e->burst_time, e->arrival_time);
+            if (!proc) break;
+            proc->priority = e->priority;
+            process_info(proc)->io_requests = e->io_requests;
+            process_info(proc)->deadline = e->deadline;
+            process_info(proc)->period = e->period;
+            slot_entry[proc - process_table] = next;
+            next++;
+            result->events++;
+        }
+
+        // 准入: 为已到达的进程分配分区 (EDF下先检查利用率和空闲分区)
+        for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+            process_t* proc = &process_table[i];
+            if (proc->state != PROC_CREATED || slot_entry[i] == SLOT_EMPTY) continue;
+
+            sched_admit_t admit = scheduler_admit(proc);
+            if (admit == SCHED_ADMIT_OK && allocate_memory(proc, current_strategy) == 0) {
+                scheduler_add_process(proc);
+                result->procs[slot_entry[i]].admit_time = now;
+                result->events++;
+            } else if (admit == SCHED_ADMIT_CPU || proc->memory_size > largest) {
+                // 利用率不足或任何分区都放不下，直接拒绝
+                terminate_process(proc);
+                result->procs[slot_entry[i]].status = SIM_PROC_REJECTED;
+                result->rejected++;
+                if (admit == SCHED_ADMIT_CPU) result->rt_rejected++;
+                slot_entry[i] = SLOT_EMPTY;
+                done++;
+            } else {
+                result->alloc_failures++;
+                result->procs[slot_entry[i]].memory_waits++;
+            }
+        }
+
+        // 调度并执行一个时间单位
+        if (tick()) {
+            result->busy_ticks++;
+            result->events++;
+        }
+
+        // 完成
+        for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+            process_t* proc = &process_table[i];
+            if (slot_entry[i] == SLOT_EMPTY || proc->state != PROC_TERMINATED) continue;
+
+            const trace_entry_t* e = &trace->entries[slot_entry[i]];
+            sim_proc_result_t* p = &result->procs[slot_entry[i]];
+            p->status = SIM_PROC_COMPLETED;
+            const process_info_t* info = process_info(proc);
+            p->start_time = info->start_time;
+            p->finish_time = info->finish_time;
+            p->turnaround = info->finish_time + 1 - e->arrival_time;
+            p->waiting = p->turnaround - e->burst_time - info->io_time;
+            p->response = info->start_time - e->arrival_time;
+            slot_entry[i] = SLOT_EMPTY;
+            result->completed++;
+            result->events++;
+            done++;
+        }
+
+        if (now % interval == 0) {
+            take_sample(result, now);
+        }
+
+        advance_time();
+        result->ticks++;
+    }
+
+    result->unfinished = trace->count - done;
+    summarize(result, trace);
+
+    frag_stats_t fs;
+    frag_get_stats(&fs);
+    result->avg_alloc_waste = fs.allocations ? (double)fs.waste_total / fs.allocations : 0;
+    result->mean_internal_frag = fs.mean_internal_frag;
+    result->mean_external_frag = fs.mean_external_frag;
+    result->failures_despite_free = fs.failures_despite_free;
+
+    adapt_stats_t as;
+    adapt_get_stats(&as);
+    result->splits = as.splits;
+    result->merges = as.merges;
+    traffic_get_stats(&result->traffic);
+    io_get_stats(&result->io);
+    swap_get_stats(&result->swap);
+    scheduler_get_rt_stats(&result->rt);
+    adapt_set_enabled(0);
+    traffic_set_pattern(TRAFFIC_NONE, 0, 0);
+    io_set_service_time(0);
+    io_set_scheduler(IO_SCHED_FIFO);
+    swap_set_enabled(0);
+    swap_set_policy(RECLAIM_PRIORITY);
+    free(slot_entry);
+    return 0;
+}
+
+void sim_result_free(sim_result_t* result) {
+    free(result->procs);
+    free(result->samples);
+    result->procs = NULL;
+    result->samples = NULL;
+    result->sample_count = 0;
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#ifndef _SIM_H
+#define _SIM_H
+
+#include "os_types.h"
+#include "memory.h"
+#include "scheduler.h"
+#include "traffic.h"
+#include "io.h"
+#include "swap.h"
+
+// 工作负载轨迹中的一个进程
+typedef struct trace_entry_t {
+    uint32_t arrival_time;   // 到达时间
+    uint32_t memory_size;    // 内存需求
+    uint32_t burst_time;     // 执行时间
+    uint32_t priority;       // 优先级 (越小越高)
+    uint32_t io_requests;    // 执行期间的I/O请求数
+    uint32_t deadline;       // 相对截止时间，0为非实时进程
+    uint32_t period;         // 周期 (EDF准入的利用率为 执行时间/周期)，0表示与截止时间相同
+} trace_entry_t;
+
+// 工作负载轨迹 (按到达时间排序)
+typedef struct trace_t {
+    trace_entry_t* entries;
+    uint32_t count;
+} trace_t;
+
+// 随机轨迹参数
+typedef struct trace_params_t {
+    uint32_t count;              // 进程数
+    uint32_t seed;               // 随机种子
+    uint32_t min_memory;         // 内存需求范围
+    uint32_t max_memory;
+    uint32_t min_burst;          // 执行时间范围
+    uint32_t max_burst;
+    uint32_t max_interarrival;   // 到达间隔在 [0, max_interarrival] 内均匀分布
+    uint32_t phase_length;       // 非0时每隔这么多进程在两种内存需求范围之间切换
+    uint32_t alt_min_memory;     // 另一阶段的内存需求范围
+    uint32_t alt_max_memory;
+    uint32_t max_io_requests;    // 每个进程的I/O请求数在 [0, max_io_requests] 内均匀分布，0为纯计算负载
+    uint32_t rt_percent;         // 实时进程所占百分比，0为没有实时进程
+    uint32_t rt_max_slack;       // 实时进程的截止时间为执行时间的 [2, rt_max_slack] 倍，周期等于截止时间
+} trace_params_t;
+
+// 模拟配置
+typedef struct sim_config_t {
+    allocation_strategy_t strategy;
+    scheduler_type_t scheduler;
+    uint32_t max_ticks;          // 最多模拟的时间单位
+    uint32_t sample_interval;    // 内存利用率采样间隔
+    int adaptive;                // 启用自适应分区
+    traffic_pattern_t traffic;   // 进程访存模型 (TRAFFIC_NONE关闭)
+    uint32_t traffic_accesses;   // 每时间单位访问次数，0为默认值
+    uint32_t traffic_stride;     // 步长，0为默认值
+    uint32_t io_service_time;    // I/O服务时间 (不含寻道)，0为默认值
+    io_sched_t io_sched;         // 磁盘调度算法
+    int swap;                    // 启用交换
+    reclaim_policy_t reclaim;    // 交换时选择换出进程的策略
+} sim_config_t;
+
+// 单个进程的结果
+typedef enum {
+    SIM_PROC_UNFINISHED,   // 模拟结束时仍未完成
+    SIM_PROC_COMPLETED,    // 正常完成
+    SIM_PROC_REJECTED      // 内存需求超过最大分区或EDF利用率不足，无法准入
+} sim_proc_status_t;
+
+typedef struct sim_proc_result_t {
+    sim_proc_status_t status;
+    uint32_t admit_time;       // 分配到内存的时间
+    uint32_t start_time;       // 首次运行时间
+    uint32_t finish_time;      // 完成时间
+    uint32_t turnaround;       // 周转时间 = 完成 - 到达
+    uint32_t waiting;          // 等待时间 = 周转 - 执行 - 阻塞在I/O上的时间
+    uint32_t response;         // 响应时间 = 首次运行 - 到达
+    uint32_t memory_waits;     // 因没有可用分区推迟准入的时间单位数
+    int32_t lateness;          // 完成的实时进程: 周转 - 截止时间 (提前完成为负)
+} sim_proc_result_t;
+
+// 内存利用率采样
+typedef struct sim_sample_t {
+    uint32_t time;
+    uint32_t allocated_bytes;  // 已分配分区的总大小
+    uint32_t requested_bytes;  // 驻留进程实际需要的内存
+    uint32_t ready_count;      // 就绪队列长度
+} sim_sample_t;
+
+// 模拟结果
+typedef struct sim_result_t {
+    uint32_t ticks;            // 模拟的时间单位
+    uint32_t busy_ticks;       // CPU忙碌的时间单位 (CPU利用率 = busy_ticks / ticks)
+    uint32_t completed;
+    uint32_t rejected;
+    uint32_t unfinished;
+    uint64_t events;           // 到达 + 准入 + 执行 + 完成 事件数
+    uint64_t alloc_failures;   // 分配失败次数 (进程将在下个时间单位重试)
+    uint32_t user_memory;      // 用户分区总大小
+
+    double avg_turnaround;
+    double avg_waiting;
+    double avg_response;
+    double avg_admit_delay;    // 到达到分配内存的平均等待
+    double avg_hold;           // 完成进程占用分区的平均时间 (分配到完成)
+    uint32_t p95_turnaround;
+    double mean_alloc_util;    // 平均分区占用率
+    double mean_req_util;      // 平均有效利用率 (扣除分区内部浪费)
+    double peak_alloc_util;
+    double avg_alloc_waste;          // 每次分配的平均内部浪费 (字节)
+    double mean_internal_frag;       // 内部浪费 / 已分配，按时间平均
+    double mean_external_frag;       // 1 - 最大空闲块 / 总空闲，按时间平均
+    uint64_t failures_despite_free;  // 总空闲足够却没有分区能容纳的次数
+    uint32_t splits;                 // 自适应拆分/合并次数
+    uint32_t merges;
+    traffic_stats_t traffic;         // 访存模型统计
+    io_stats_t io;                   // I/O设备统计 (设备利用率 = io.busy_ticks / ticks)
+    swap_stats_t swap;               // 交换统计
+    uint32_t rt_tasks;               // 实时进程数
+    uint32_t rt_rejected;            // 被EDF准入拒绝的实时进程
+    uint32_t rt_misses;              // 完成时已过截止时间，或模拟结束时未完成且已过截止时间
+    uint32_t rt_misses_waited;       // 其中曾因没有可用分区推迟准入的
+    uint32_t rt_waited;              // 曾因没有可用分区推迟准入的实时进程
+    double rt_mean_lateness;         // 完成的实时进程的平均 (周转 - 截止时间)
+    int32_t rt_max_lateness;
+    double rt_avg_memory_wait;       // 实时进程因没有可用分区推迟准入的平均时间单位数
+    rt_stats_t rt;                   // 调度器的实时统计 (准入、抢占)
+
+    sim_proc_result_t* procs;  // 与轨迹一一对应
+    sim_sample_t* samples;
+    uint32_t sample_count;
+} sim_result_t;
+
+// 轨迹
+int trace_generate(trace_t* trace, const trace_params_t* params);
+int trace_load(trace_t* trace, const char* path);
+int trace_save(const trace_t* trace, const char* path);
+void trace_free(trace_t* trace);
+void trace_default_params(trace_params_t* params);
+
+// 从kernel_init()开始完整运行一次轨迹 (结束后可用frag_get_series()取碎片时间序列)
+int sim_run(const trace_t* trace, const sim_config_t* config, sim_result_t* result);
+void sim_result_free(sim_result_t* result);
+
+const char* sim_strategy_name(allocation_strategy_t strategy);
+const char* sim_scheduler_name(scheduler_type_t type);
+
+#endif // _SIM_H
\ No newline at end of file
@@ -0,0 +1,448 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "os_types.h"
+#include "config.h"
+#include "log.h"
+#include "kernel.h"
+#include "snapshot.h"
+
+#define SNAPSHOT_MAGIC 0x534D5046u   // "FPMS"
+#define SNAPSHOT_VERSION 11
+#define NO_INDEX 0xFFFFFFFFu
+
+// 文件头：配置常量和结构大小必须与当前程序一致
+typedef struct snapshot_header_t {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t memory_size;
+    uint32_t max_partitions;
+    uint32_t max_processes;
+    uint32_t frag_series_size;
+    uint32_t partition_size;      // sizeof(partition_t)
+    uint32_t process_size;        // sizeof(process_t)
+    uint32_t process_info_size;   // sizeof(process_info_t)
+    uint32_t frag_stats_size;     // sizeof(frag_stats_t)
+    uint32_t adapt_size;          // sizeof(adapt_state_t)
+    uint32_t traffic_size;        // sizeof(traffic_state_t)
+    uint32_t io_size;             // sizeof(io_state_t)
+    uint32_t swap_stats_size;     // sizeof(swap_stats_t)
+} snapshot_header_t;
+
+static void fill_header(snapshot_header_t* h) {
+    memset(h, 0, sizeof(*h));
+    h->magic = SNAPSHOT_MAGIC;
+    h->version = SNAPSHOT_VERSION;
+    h->memory_size = MEMORY_SIZE;
+    h->max_partitions = MAX_PARTITIONS;
+    h->max_processes = MAX_PROCESSES;
+    h->frag_series_size = FRAG_SERIES_SIZE;
+    h->partition_size = sizeof(partition_t);
+    h->process_size = sizeof(process_t);
+    h->process_info_size = sizeof(process_info_t);
+    h->frag_stats_size = sizeof(frag_stats_t);
+    h->adapt_size = sizeof(adapt_state_t);
+    h->traffic_size = sizeof(traffic_state_t);
+    h->io_size = sizeof(io_state_t);
+    h->swap_stats_size = sizeof(swap_stats_t);
+}
+
+static uint32_t proc_index(const kernel_ctx_t* ctx, const process_t* proc) {
+    return proc ? (uint32_t)(proc - ctx->procs) : NO_INDEX;
+}
+
+static int put(FILE* f, const void* data, size_t size) {
+    return size == 0 || fwrite(data, size, 1, f) == 1 ? 0 : -1;
+}
+
+static int get(FILE* f, void* data, size_t size) {
+    return size == 0 || fread(data, size, 1, f) == 1 ? 0 : -1;
+}
+
+static int put_u32(FILE* f, uint32_t v) {
+    return put(f, &v, sizeof(v));
+}
+
+// 格式: 头 | 时间 策略 | 分区表 | 布局 | next_pid 进程表 (只含未终止的进程) |
+//       调度器 | 碎片统计 | 自适应状态 | 访存模型 | I/O设备 | 交换状态 | 换出的映像 | 系统内存
+int kernel_snapshot(const char* path) {
+    const kernel_ctx_t* ctx = kernel_ctx_current();
+    const scheduler_t* s = &ctx->sched;
+    snapshot_header_t h;
+    uint32_t live = 0;
+    int err = 0;
+    FILE* f = fopen(path, "wb");
+
+    if (!f) {
+        kernel_log(LOG_ERR, "Snapshot: cannot open %s", path);
+        return -1;
+    }
+
+    fill_header(&h);
+    err |= put(f, &h, sizeof(h));
+    err |= put_u32(f, ctx->current_time);
+    err |= put_u32(f, (uint32_t)ctx->strategy);
+
+    err |= put_u32(f, ctx->part_count);
+    err |= put(f, ctx->parts, sizeof(partition_t) * ctx->part_count);
+    err |= put_u32(f, ctx->layout_count);
+    err |= put(f, ctx->layout_sizes, sizeof(uint32_t) * ctx->layout_count);
+
+    // 进程: 下标 + 记录 (队列链接本身就是下标) + 冷数据
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        if (ctx->procs[i].state != PROC_TERMINATED) live++;
+    }
+    err |= put_u32(f, ctx->next_pid);
+    err |= put_u32(f, live);
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        if (ctx->procs[i].state == PROC_TERMINATED) continue;
+        err |= put_u32(f, i);
+        err |= put(f, &ctx->procs[i], sizeof(process_t));
+        err |= put(f, &ctx->proc_info[i], sizeof(process_info_t));
+    }
+
+    err |= put_u32(f, (uint32_t)s->type);
+    err |= put_u32(f, s->time_slice);
+    err |= put_u32(f, s->current_time_slice);
+    err |= put_u32(f, s->ready_queue.count);
+    err |= put_u32(f, s->ready_queue.front);
+    err |= put_u32(f, s->ready_queue.rear);
+    err |= put_u32(f, proc_index(ctx, s->current_process));
+    err |= put_u32(f, s->edf.count);
+    err |= put_u32(f, s->edf.seq);
+    err |= put(f, s->edf.key, sizeof(uint64_t) * s->edf.count);
+    err |= put(f, s->edf.slot, sizeof(uint32_t) * s->edf.count);
+    err |= put(f, &s->rt, sizeof(rt_stats_t));
+
+    // 碎片时间序列只写有效部分
+    err |= put(f, &ctx->frag.stats, sizeof(frag_stats_t));
+    err |= put(f, &ctx->frag.internal_sum, sizeof(double));
+    err |= put(f, &ctx->frag.external_sum, sizeof(double));
+    err |= put_u32(f, ctx->frag.series_count);
+    err |= put_u32(f, ctx->frag.series_interval);
+    err |= put_u32(f, ctx->frag.next_sample_time);
+    err |= put(f, ctx->frag.series, sizeof(frag_sample_t) * ctx->frag.series_count);
+
+    err |= put(f, &ctx->adapt, sizeof(adapt_state_t));
+    err |= put(f, &ctx->traffic, sizeof(traffic_state_t));
+    err |= put(f, &ctx->io, sizeof(io_state_t));
+
+    // 交换: 后备文件不保存，换出进程的映像按槽位顺序写入快照
+    const swap_state_t* sw = &ctx->swap;
+    err |= put_u32(f, (uint32_t)sw->enabled);
+    err |= put_u32(f, (uint32_t)sw->policy);
+    err |= put_u32(f, sw->queue.count);
+    err |= put_u32(f, sw->queue.front);
+    err |= put_u32(f, sw->queue.rear);
+    err |= put_u32(f, sw->swapped_count);
+    err |= put_u32(f, sw->loading);
+    err |= put_u32(f, sw->busy_until);
+    err |= put(f, &sw->stats, sizeof(swap_stats_t));
+    uint8_t* image = NULL;
+    for (uint32_t i = 0; i < MAX_PROCESSES && !err; i++) {
+        if (ctx->procs[i].state == PROC_TERMINATED || !ctx->proc_info[i].swapped) continue;
+        uint32_t size = ctx->procs[i].memory_size;
+        uint8_t* buf = (uint8_t*)realloc(image, size ? size : 1);
+        if (!buf) {
+            err = -1;
+            break;
+        }
+        image = buf;
+        err |= swap_read_image(i, image, size);
+        err |= put(f, image, size);
+    }
+    free(image);
+
+    const uint8_t* memory = get_memory_base();
+    err |= memory ? put(f, memory, MEMORY_SIZE) : -1;
+
+    if (fclose(f) != 0) err = -1;
+    if (err) {
+        kernel_log(LOG_ERR, "Snapshot: write to %s failed", path);
+        return -1;
+    }
+    kernel_log(LOG_INFO, "Snapshot saved to %s at time %d (%d processes)", path, ctx->current_time, live);
+    return 0;
+}
+
+// 恢复时的中间结果
+typedef struct restore_state_t {
+    uint8_t used[MAX_PROCESSES];   // 1: 已恢复，2: 已恢复且在就绪队列、设备队列、交换队列中或正在服务/换入
+    uint32_t current;              // 当前进程下标
+    uint32_t live;
+    uint8_t* images;               // 换出进程的映像 (按槽位顺序)，提交后写入后备文件
+} restore_state_t;
+
+// 下标是否指向一个已恢复的进程
+static int valid_index(const restore_state_t* rs, uint32_t idx) {
+    return idx == NO_INDEX || (idx < MAX_PROCESSES && rs->used[idx]);
+}
+
+// 队列必须从front沿next恰好count步走到rear，prev与next一致，且成员都处于state状态
+static int check_queue(const kernel_ctx_t* tmp, restore_state_t* rs, const proc_queue_t* q,
+    process_state_t state) {
+    uint32_t idx = q->front, last = PROC_NONE, steps = 0;
+
+    while (idx != PROC_NONE && steps < q->count) {
+        if (idx >= MAX_PROCESSES || rs->used[idx] != 1 || tmp->procs[idx].prev != last ||
+            tmp->procs[idx].state != state) {
+            return -1;
+        }
+        rs->used[idx] = 2;
+        last = idx;
+        idx = tmp->procs[idx].next;
+        steps++;
+    }
+    return idx != PROC_NONE || steps != q->count || last != q->rear ? -1 : 0;
+}
+
+// 0号为操作系统分区，其后首尾相接且不超出内存，空闲分区无所有者；
+// 每个已分配分区恰好被一个已恢复、未换出的进程持有 (按起始地址二分查找)，地址范围与进程记录一致
+static int check_partitions(const kernel_ctx_t* tmp, const restore_state_t* rs) {
+    const partition_t* parts = tmp->parts;
+    uint32_t allocated = 0, held = 0;
+
+    if (tmp->part_count == 0 || parts[0].start != 0 || parts[0].size != OS_PARTITION_SIZE ||
+        parts[0].state != PARTITION_OS) {
+        return -1;
+    }
+    for (uint32_t i = 1; i < tmp->part_count; i++) {
+        const partition_t* part = &parts[i];
+        if (part->start != parts[i - 1].start + parts[i - 1].size || part->size == 0 ||
+            part->size > MEMORY_SIZE - part->start || part->used_size > part->size) {
+            return -1;
+        }
+        if (part->state == PARTITION_ALLOCATED) allocated++;
+        else if (part->state != PARTITION_FREE || part->owner_pid != 0 || part->used_size != 0) return -1;
+    }
+
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        const process_info_t* info = &tmp->proc_info[i];
+        if (!rs->used[i] || info->swapped || info->memory_start == 0) continue;
+        uint32_t lo = 1, hi = tmp->part_count;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (parts[mid].start < info->memory_start) lo = mid + 1;
+            else hi = mid;
+        }
+        const partition_t* part = &parts[lo];
+        if (lo == tmp->part_count || part->start != info->memory_start || part->state != PARTITION_ALLOCATED ||
+            part->owner_pid != tmp->procs[i].pid || tmp->procs[i].memory_size > part->size ||
+            info->memory_end != part->start + part->size - 1) {
+            return -1;
+        }
+        held++;
+    }
+    return held == allocated ? 0 : -1;
+}
+
+// 读入临时上下文并检查一致性，返回-1表示文件截断或损坏
+static int read_snapshot(FILE* f, kernel_ctx_t* tmp, restore_state_t* rs) {
+    uint32_t strategy, type;
+    int err = 0;
+
+    err |= get(f, &tmp->current_time, sizeof(uint32_t));
+    err |= get(f, &strategy, sizeof(uint32_t));
+    tmp->strategy = (allocation_strategy_t)strategy;
+
+    err |= get(f, &tmp->part_count, sizeof(uint32_t));
+    if (err || tmp->part_count > MAX_PARTITIONS) return -1;
+    err |= get(f, tmp->parts, sizeof(partition_t) * tmp->part_count);
+    err |= get(f, &tmp->layout_count, sizeof(uint32_t));
+    if (err || tmp->layout_count >= MAX_PARTITIONS) return -1;
+    err |= get(f, tmp->layout_sizes, sizeof(uint32_t) * tmp->layout_count);
+
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        tmp->procs[i].state = PROC_TERMINATED;
+        tmp->procs[i].next = PROC_NONE;
+        tmp->procs[i].prev = PROC_NONE;
+        rs->used[i] = 0;
+    }
+    err |= get(f, &tmp->next_pid, sizeof(uint32_t));
+    err |= get(f, &rs->live, sizeof(uint32_t));
+    if (err || rs->live > MAX_PROCESSES) return -1;
+    for (uint32_t n = 0; n < rs->live; n++) {
+        uint32_t idx;
+        if (get(f, &idx, sizeof(idx)) != 0 || idx >= MAX_PROCESSES || rs->used[idx]) return -1;
+        err |= get(f, &tmp->procs[idx], sizeof(process_t));
+        err |= get(f, &tmp->proc_info[idx], sizeof(process_info_t));
+        if (err || tmp->procs[idx].state == PROC_TERMINATED) return -1;
+        rs->used[idx] = 1;
+    }
+
+    err |= get(f, &type, sizeof(uint32_t));
+    err |= get(f, &tmp->sched.time_slice, sizeof(uint32_t));
+    err |= get(f, &tmp->sched.current_time_slice, sizeof(uint32_t));
+    err |= get(f, &tmp->sched.ready_queue.count, sizeof(uint32_t));
+    err |= get(f, &tmp->sched.ready_queue.front, sizeof(uint32_t));
+    err |= get(f, &tmp->sched.ready_queue.rear, sizeof(uint32_t));
+    err |= get(f, &rs->current, sizeof(uint32_t));
+    tmp->sched.type = (scheduler_type_t)type;
+    if (err || type > SCHED_EDF || !valid_index(rs, rs->current) ||
+        check_queue(tmp, rs, &tmp->sched.ready_queue, PROC_READY) != 0) {
+        return -1;
+    }
+
+    // EDF就绪堆: 成员都就绪且不在就绪队列中，键与进程的截止时间一致并满足堆序；已预留的利用率重新累计
+    deadline_heap_t* heap = &tmp->sched.edf;
+    err |= get(f, &heap->count, sizeof(uint32_t));
+    if (err || heap->count > MAX_PROCESSES || (heap->count && type != SCHED_EDF)) return -1;
+    err |= get(f, &heap->seq, sizeof(uint32_t));
+    err |= get(f, heap->key, sizeof(uint64_t) * heap->count);
+    err |= get(f, heap->slot, sizeof(uint32_t) * heap->count);
+    err |= get(f, &tmp->sched.rt, sizeof(rt_stats_t));
+    if (err) return -1;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        heap->pos[i] = PROC_NONE;
+    }
+    for (uint32_t i = 0; i < heap->count; i++) {
+        uint32_t idx = heap->slot[i];
+        if (idx >= MAX_PROCESSES || rs->used[idx] != 1 || tmp->procs[idx].state != PROC_READY ||
+            heap->key[i] >> 32 != rt_absolute_deadline(tmp->procs[idx].arrival_time, tmp->proc_info[idx].deadline) ||
+            (i > 0 && heap->key[(i - 1) / 2] > heap->key[i])) {
+            return -1;
+        }
+        rs->used[idx] = 2;
+        heap->pos[idx] = i;
+    }
+    uint64_t rt_util = 0;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        if (rs->used[i]) rt_util += tmp->proc_info[i].rt_util;
+    }
+    if (rt_util > RT_UTIL_SCALE) return -1;
+    tmp->sched.rt_util = (uint32_t)rt_util;
+
+    err |= get(f, &tmp->frag.stats, sizeof(frag_stats_t));
+    err |= get(f, &tmp->frag.internal_sum, sizeof(double));
+    err |= get(f, &tmp->frag.external_sum, sizeof(double));
+    err |= get(f, &tmp->frag.series_count, sizeof(uint32_t));
+    err |= get(f, &tmp->frag.series_interval, sizeof(uint32_t));
+    err |= get(f, &tmp->frag.next_sample_time, sizeof(uint32_t));
+    if (err || tmp->frag.series_count > FRAG_SERIES_SIZE) return -1;
+    err |= get(f, tmp->frag.series, sizeof(frag_sample_t) * tmp->frag.series_count);
+
+    err |= get(f, &tmp->adapt, sizeof(adapt_state_t));
+    err |= get(f, &tmp->traffic, sizeof(traffic_state_t));
+    err |= get(f, &tmp->io, sizeof(io_state_t));
+    if (err || check_queue(tmp, rs, &tmp->io.queue, PROC_WAITING) != 0) return -1;
+    if (tmp->io.sched >= IO_SCHED_COUNT || tmp->io.head >= DISK_TRACKS) return -1;
+
+    // 正在服务的请求不在设备队列中，且服务时间未用完
+    uint32_t active = tmp->io.active;
+    if (active != PROC_NONE) {
+        if (active >= MAX_PROCESSES || rs->used[active] != 1 || tmp->procs[active].state != PROC_WAITING ||
+            tmp->io.service_left == 0) {
+            return -1;
+        }
+        rs->used[active] = 2;
+    }
+
+    uint32_t enabled, policy;
+    swap_state_t* sw = &tmp->swap;
+    err |= get(f, &enabled, sizeof(uint32_t));
+    err |= get(f, &policy, sizeof(uint32_t));
+    err |= get(f, &sw->queue.count, sizeof(uint32_t));
+    err |= get(f, &sw->queue.front, sizeof(uint32_t));
+    err |= get(f, &sw->queue.rear, sizeof(uint32_t));
+    err |= get(f, &sw->swapped_count, sizeof(uint32_t));
+    err |= get(f, &sw->loading, sizeof(uint32_t));
+    err |= get(f, &sw->busy_until, sizeof(uint32_t));
+    err |= get(f, &sw->stats, sizeof(swap_stats_t));
+    sw->enabled = (int)enabled;
+    sw->policy = (reclaim_policy_t)policy;
+    if (err || policy >= RECLAIM_COUNT || check_queue(tmp, rs, &sw->queue, PROC_SUSPENDED) != 0) return -1;
+
+    // 正在换入的进程已有分区
+    if (sw->loading != PROC_NONE) {
+        if (sw->loading >= MAX_PROCESSES || rs->used[sw->loading] != 1 ||
+            tmp->procs[sw->loading].state != PROC_SUSPENDED || tmp->proc_info[sw->loading].swapped) {
+            return -1;
+        }
+        rs->used[sw->loading] = 2;
+    }
+
+    // 不在任何队列中的进程不能有链接，等待I/O的进程必须在设备上，挂起的进程必须在交换队列中或正在换入；
+    // 只有等待和挂起的进程可以换出，交换队列中的都已换出
+    uint32_t swapped = 0;
+    uint64_t image_bytes = 0;
+    for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+        const process_t* p = &tmp->procs[i];
+        if (rs->used[i] != 2 && (p->next != PROC_NONE || p->prev != PROC_NONE)) return -1;
+        if (rs->used[i] == 1 && (p->state == PROC_WAITING || p->state == PROC_SUSPENDED)) return -1;
+        if (!rs->used[i] || !tmp->proc_info[i].swapped) {
+            if (rs->used[i] && p->state == PROC_SUSPENDED && i != sw->loading) return -1;
+            continue;
+        }
+        if ((p->state != PROC_WAITING && p->state != PROC_SUSPENDED) || p->memory_size > SWAP_SLOT_SIZE) return -1;
+        swapped++;
+        image_bytes += p->memory_size;
+    }
+    if (swapped != sw->swapped_count || check_partitions(tmp, rs) != 0) return -1;
+    rs->images = (uint8_t*)malloc(image_bytes ? (size_t)image_bytes : 1);
+    if (!rs->images || get(f, rs->images, (size_t)image_bytes) != 0) return -1;
+
+    // 其后恰好是系统内存，提交后直接读入当前映射
+    long pos = ftell(f);
+    if (pos < 0 || fseek(f, 0, SEEK_END) != 0) return -1;
+    long end = ftell(f);
+    if (end - pos != (long)MEMORY_SIZE || fseek(f, pos, SEEK_SET) != 0) return -1;
+    return 0;
+}
+
+// 全部读入并检查通过后才替换当前上下文，失败时当前状态不变
+int kernel_restore(const char* path) {
+    kernel_ctx_t* ctx = kernel_ctx_current();
+    snapshot_header_t h, expect;
+    FILE* f = fopen(path, "rb");
+
+    if (!f) {
+        kernel_log(LOG_ERR, "Snapshot: cannot open %s", path);
+        return -1;
+    }
+    fill_header(&expect);
+    if (get(f, &h, sizeof(h)) != 0 || memcmp(&h, &expect, sizeof(h)) != 0) {
+        fclose(f);
+        kernel_log(LOG_ERR, "Snapshot: %s was written by an incompatible build", path);
+        return -1;
+    }
+
+    kernel_ctx_t* tmp = kernel_ctx_create();
+    restore_state_t* rs = (restore_state_t*)malloc(sizeof(restore_state_t));
+    if (rs) rs->images = NULL;
+    uint8_t* memory = get_memory_base();
+    int err = !tmp || !rs || !memory || read_snapshot(f, tmp, rs) != 0;
+
+    if (err) {
+        kernel_log(LOG_ERR, "Snapshot: %s is truncated or corrupt", path);
+    } else {
+        // 保留当前日志、内存映射和后备文件，当前进程按下标重建指针
+        memcpy(&tmp->log, &ctx->log, sizeof(log_state_t));
+        tmp->mem = ctx->mem;
+        tmp->swap.path = ctx->swap.path;
+        tmp->swap.file = ctx->swap.file;
+        memcpy(ctx, tmp, sizeof(kernel_ctx_t));
+        tmp->mem.base = NULL;
+        tmp->swap.file = NULL;
+        partition_sync_index();
+        const uint8_t* image = rs->images;
+        for (uint32_t i = 0; i < MAX_PROCESSES; i++) {
+            if (ctx->procs[i].state == PROC_TERMINATED || !ctx->proc_info[i].swapped) continue;
+            if (swap_write_image(i, image, ctx->procs[i].memory_size) != 0) {
+                kernel_log(LOG_ERR, "Snapshot: writing swapped image of PID=%d failed", ctx->procs[i].pid);
+                err = 1;
+            }
+            image += ctx->procs[i].memory_size;
+        }
+        if (get(f, memory, MEMORY_SIZE) != 0) {
+            kernel_log(LOG_ERR, "Snapshot: reading memory from %s failed", path);
+            err = 1;
+        }
+        ctx->sched.current_process = rs->current == NO_INDEX ? NULL : &ctx->procs[rs->current];
+        kernel_log(LOG_INFO, "Snapshot restored from %s at time %d (%d processes)", path,
+            ctx->current_time, rs->live);
+    }
+    fclose(f);
+    if (rs) free(rs->images);
+    free(rs);
+    kernel_ctx_destroy(tmp);
+    return err ? -1 : 0;
+}
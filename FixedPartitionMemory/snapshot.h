@@ -0,0 +1,13 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include "os_types.h"
+
+// 内核状态检查点
+// 保存当前上下文的分区表、进程表、就绪队列、调度器、分配策略、时钟、系统内存、换出进程的映像以及碎片/自适应统计，
+// 恢复后可以从该时刻继续模拟 (日志不保存)。就绪队列和当前进程按进程表下标保存；
+// 文件为本机字节序，头部记录配置常量和结构大小，不匹配时拒绝恢复
+int kernel_snapshot(const char* path);
+int kernel_restore(const char* path);
+
+#endif // _SNAPSHOT_H
@@ -0,0 +1,280 @@
+#include "os_types.h"
+#include "config.h"
+#include "log.h"
+#include "kernel.h"
+#include "swap.h"
+
+// 交换状态位于当前内核上下文
+#define SWAP (kernel_ctx_current()->swap)
+
+void swap_set_enabled(int on) {
+    SWAP.enabled = on;
+}
+
+int swap_get_enabled(void) {
+    return SWAP.enabled;
+}
+
+void swap_set_policy(reclaim_policy_t p) {
+    SWAP.policy = p < RECLAIM_COUNT ? p : RECLAIM_PRIORITY;
+}
+
+reclaim_policy_t swap_get_policy(void) {
+    return SWAP.policy;
+}
+
+const char* reclaim_policy_name(reclaim_policy_t p) {
+    switch (p) {
+        case RECLAIM_PRIORITY: return "priority";
+        case RECLAIM_REMAINING: return "remaining";
+        case RECLAIM_WASTE: return "waste";
+        case RECLAIM_YOUNGEST: return "youngest";
+        default: return "unknown";
+    }
+}
+
+int swap_set_backing(const char* backing) {
+    swap_close();
+    SWAP.path = backing;
+    return 0;
+}
+
+void swap_close(void) {
+    if (SWAP.file) {
+        fclose(SWAP.file);
+        SWAP.file = NULL;
+    }
+}
+
+void swap_reset(void) {
+    proc_queue_init(&SWAP.queue);
+    SWAP.swapped_count = 0;
+    SWAP.loading = PROC_NONE;
+    SWAP.busy_until = 0;
+    memset(&SWAP.stats, 0, sizeof(SWAP.stats));
+}
+
+// 后备文件在第一次换出时打开，未指定路径时使用临时文件
+static int open_backing(void) {
+    if (SWAP.file) return 0;
+
+    SWAP.file = SWAP.path ? fopen(SWAP.path, "w+b") : tmpfile();
+    if (!SWAP.file) {
+        kernel_log(LOG_ERR, "Swap: cannot open %s", SWAP.path ? SWAP.path : "temporary file");
+        return -1;
+    }
+    return 0;
+}
+
+// 定位到槽位的区域 (文件可能超过2GB)
+static int seek_slot(uint32_t slot) {
+    uint64_t off = (uint64_t)slot * SWAP_SLOT_SIZE;
+#ifdef _WIN32
+    return _fseeki64(SWAP.file, (__int64)off, SEEK_SET);
+#else
+    return fseeko(SWAP.file, (off_t)off, SEEK_SET);
+#endif
+}
+
+// 整个映像一次顺序写入/读出
+int swap_write_image(uint32_t slot, const uint8_t* data, uint32_t size) {
+    if (open_backing() != 0 || seek_slot(slot) != 0 ||
+        (size && fwrite(data, size, 1, SWAP.file) != 1) || fflush(SWAP.file) != 0) {
+        SWAP.stats.errors++;
+        return -1;
+    }
+    return 0;
+}
+
+int swap_read_image(uint32_t slot, uint8_t* data, uint32_t size) {
+    if (open_backing() != 0 || seek_slot(slot) != 0 || (size && fread(data, size, 1, SWAP.file) != 1)) {
+        SWAP.stats.errors++;
+        return -1;
+    }
+    return 0;
+}
+
+// 占用交换通道传输bytes字节
+static void transfer(uint32_t now, uint32_t bytes) {
+    uint32_t cost = SWAP_LATENCY + (bytes + SWAP_BYTES_PER_TICK - 1) / SWAP_BYTES_PER_TICK;
+    SWAP.busy_until = (SWAP.busy_until > now ? SWAP.busy_until : now) + cost;
+    SWAP.stats.busy_ticks += cost;
+}
+
+static int swap_out(process_t* proc, partition_t* part, uint32_t now) {
+    process_info_t* info = process_info(proc);
+
+    if (swap_write_image((uint32_t)(proc - process_table), get_memory_base() + part->start, proc->memory_size) != 0) {
+        kernel_log(LOG_ERR, "Swap: writing PID=%d failed", proc->pid);
+        return -1;
+    }
+    free_partition(part);
+    info->memory_start = 0;
+    info->memory_end = 0;
+    info->swapped = 1;
+    info->swap_time = now;
+
+    // 就绪进程挂起；等待I/O的进程留在设备上，完成后再挂起
+    if (proc->state == PROC_READY) {
+        scheduler_ready_remove(proc);
+        process_set_state(proc, PROC_SUSPENDED);
+        proc_queue_push(&SWAP.queue, proc);
+    }
+    if (++SWAP.swapped_count > SWAP.stats.max_swapped) SWAP.stats.max_swapped = SWAP.swapped_count;
+    transfer(now, proc->memory_size);
+    SWAP.stats.swap_outs++;
+    SWAP.stats.bytes_out += proc->memory_size;
+    return 0;
+}
+
+// 分区的占有者可以换出时返回该进程
+static process_t* victim_of(const partition_t* part, const process_t* requester, uint32_t now) {
+    if (part->state != PARTITION_ALLOCATED) return NULL;
+
+    process_t* p = find_process_by_pid(part->owner_pid);
+    if (!p || (p->state != PROC_READY && p->state != PROC_WAITING) || process_info(p)->swapped) return NULL;
+    if (requester && (p->priority <= requester->priority || now - process_info(p)->swap_time < SWAP_MIN_RESIDENT)) {
+        return NULL;
+    }
+    return p;
+}
+
+// 按回收策略换出进程的代价，越小越先换出
+static uint64_t victim_cost(const process_t* p, uint32_t part_size) {
+    switch (SWAP.policy) {
+        case RECLAIM_REMAINING: return p->remaining_time;
+        case RECLAIM_WASTE: return UINT32_MAX - (part_size - p->memory_size);
+        case RECLAIM_YOUNGEST: return UINT32_MAX - p->arrival_time;
+        default: return UINT32_MAX - p->priority;
+    }
+}
+
+int swap_reclaim(uint32_t size, const process_t* requester) {
+    uint32_t now = get_current_time();
+    uint32_t* owner = SWAP.reclaim_owner;
+    uint64_t* owner_cost = SWAP.reclaim_cost;
+
+    for (uint32_t j = 1; j < partition_count; j++) {
+        process_t* p = victim_of(&partition_table[j], requester, now);
+        owner[j] = p ? (uint32_t)(p - process_table) : PROC_NONE;
+        owner_cost[j] = p ? victim_cost(p, partition_table[j].size) : 0;
+    }
+
+    // 找一段连续分区 [first, last]: 其中的已分配分区都可换出，总大小放得下size；
+    // 换出进程最少者优先，其次代价之和最小，再次总大小最小。分区不能合并时每段只含一个分区
+    uint32_t max_run = adapt_is_enabled() ? partition_count : 1;
+    uint32_t first = 0, last = 0, best_victims = 0, best_total = 0;
+    uint64_t best_cost = 0;
+    for (uint32_t i = 1; i < partition_count; i++) {
+        uint32_t total = 0, victims = 0;
+        uint64_t cost = 0;
+        for (uint32_t j = i; j < partition_count && j - i < max_run; j++) {
+            if (partition_table[j].state != PARTITION_FREE) {
+                if (owner[j] == PROC_NONE) break;
+                victims++;
+                cost += owner_cost[j];
+            }
+            total += partition_table[j].size;
+            if (total < size) continue;
+
+            if (!first || victims < best_victims || (victims == best_victims &&
+                (cost < best_cost || (cost == best_cost && total < best_total)))) {
+                first = i;
+                last = j;
+                best_victims = victims;
+                best_cost = cost;
+                best_total = total;
+            }
+            break;
+        }
+    }
+    if (!first) return 0;
+
+    for (uint32_t j = first; j <= last; j++) {
+        if (partition_table[j].state == PARTITION_FREE) continue;
+        process_t* victim = &process_table[owner[j]];
+        if (swap_out(victim, &partition_table[j], now) != 0) return 0;
+        kernel_log(LOG_INFO, "Swap: PID=%d swapped out (%d bytes, policy %s)",
+            victim->pid, victim->memory_size, reclaim_policy_name(SWAP.policy));
+    }
+    for (; last > first; last--) {
+        partition_merge(first);
+    }
+    SWAP.stats.reclaims++;
+    DEBUG_PRINT("Swap: reclaimed %d bytes at 0x%x from %d process(es)",
+        partition_table[first].size, partition_table[first].start, best_victims);
+    return 1;
+}
+
+int swap_make_room(process_t* proc) {
+    if (!SWAP.enabled || !proc || !swap_reclaim(proc->memory_size, proc)) return 0;
+
+    kernel_log(LOG_INFO, "Swap: made room for PID=%d (%d bytes)", proc->pid, proc->memory_size);
+    return 1;
+}
+
+void swap_on_io_done(process_t* proc) {
+    process_set_state(proc, PROC_SUSPENDED);
+    proc_queue_push(&SWAP.queue, proc);
+}
+
+void swap_cancel(process_t* proc) {
+    process_info_t* info = process_info(proc);
+    uint32_t slot = (uint32_t)(proc - process_table);
+
+    if (slot == SWAP.loading) {
+        // 分区由调用者释放
+        SWAP.loading = PROC_NONE;
+    } else if (proc->state == PROC_SUSPENDED && proc_queue_contains(&SWAP.queue, proc)) {
+        proc_queue_remove(&SWAP.queue, proc);
+    }
+    if (info->swapped) {
+        info->swapped = 0;
+        SWAP.swapped_count--;
+    }
+}
+
+// 为进程分配分区并读回映像
+static void swap_in(process_t* proc, uint32_t now) {
+    process_info_t* info = process_info(proc);
+    uint32_t slot = (uint32_t)(proc - process_table);
+
+    proc_queue_remove(&SWAP.queue, proc);
+    if (allocate_memory(proc, current_strategy) != 0) {
+        proc_queue_push(&SWAP.queue, proc);
+        return;
+    }
+    if (swap_read_image(slot, get_memory_base() + info->memory_start, proc->memory_size) != 0) {
+        kernel_log(LOG_ERR, "Swap: reading PID=%d failed, image lost", proc->pid);
+    }
+    info->swapped = 0;
+    info->swap_time = now;
+    SWAP.swapped_count--;
+    SWAP.loading = slot;
+    transfer(now, proc->memory_size);
+    SWAP.stats.swap_ins++;
+    SWAP.stats.bytes_in += proc->memory_size;
+    DEBUG_PRINT("Swap: PID=%d swapping in at 0x%x", proc->pid, info->memory_start);
+}
+
+void swap_tick(uint32_t now) {
+    if (SWAP.loading != PROC_NONE && SWAP.busy_until <= now) {
+        process_t* proc = &process_table[SWAP.loading];
+        SWAP.loading = PROC_NONE;
+        scheduler_add_process(proc);
+    }
+    if (SWAP.loading != PROC_NONE || SWAP.busy_until > now || !SWAP.queue.count) return;
+
+    // 按换出顺序换入第一个放得下的进程
+    uint32_t largest = get_largest_free_block();
+    for (uint32_t i = SWAP.queue.front; i != PROC_NONE; i = process_table[i].next) {
+        if (process_table[i].memory_size <= largest) {
+            swap_in(&process_table[i], now);
+            break;
+        }
+    }
+}
+
+void swap_get_stats(swap_stats_t* out) {
+    *out = SWAP.stats;
+}
@@ -0,0 +1,74 @@
+#ifndef _SWAP_H
+#define _SWAP_H
+
+#include <stdio.h>
+#include "os_types.h"
+#include "config.h"
+#include "process.h"
+
+// 交换 (中程调度，可选)
+// 新到达的进程找不到分区时，按回收策略从优先级更低、驻留足够久的就绪或等待进程中选出最少的换出进程，
+// 把它们的映像写入后备文件并释放分区。
+// 换出的就绪进程进入 PROC_SUSPENDED 并排入交换队列；换出的等待进程留在设备上，I/O完成后再排入交换队列。
+// 每个时间单位结束时，交换通道空闲就为队列中第一个放得下的进程分配分区并读回映像，
+// 传输完成后进程回到就绪队列。每次传输占用交换通道 SWAP_LATENCY + 字节数 / SWAP_BYTES_PER_TICK 个时间单位
+#define SWAP_SLOT_SIZE (MEMORY_SIZE - OS_PARTITION_SIZE)   // 后备文件中每个进程表槽位的区域大小
+
+// 回收策略: 需要换出进程时，换出进程数相同的方案中选哪一个
+// 只有自适应分区开启时才会换出相邻的多个进程并合并它们的分区，否则每次只换出一个分区的进程
+typedef enum {
+    RECLAIM_PRIORITY,    // 优先级最低 (默认)
+    RECLAIM_REMAINING,   // 剩余执行时间最少
+    RECLAIM_WASTE,       // 分区内部碎片最大
+    RECLAIM_YOUNGEST,    // 到达最晚
+    RECLAIM_COUNT
+} reclaim_policy_t;
+
+typedef struct swap_stats_t {
+    uint64_t swap_outs;       // 换出次数
+    uint64_t swap_ins;        // 换入次数
+    uint64_t bytes_out;       // 写入后备文件的字节数
+    uint64_t bytes_in;        // 读回的字节数
+    uint64_t busy_ticks;      // 交换通道传输时间之和
+    uint64_t errors;          // 后备文件读写失败次数
+    uint64_t reclaims;        // 成功腾出分区的次数
+    uint32_t max_swapped;     // 同时换出的最大进程数
+} swap_stats_t;
+
+// 交换状态 (每个内核上下文一份)
+typedef struct swap_state_t {
+    int enabled;
+    reclaim_policy_t policy;
+    const char* path;         // 后备文件，NULL为临时文件 (由调用者保持有效)
+    FILE* file;               // 已打开的后备文件，NULL表示尚未打开
+    proc_queue_t queue;       // 已换出、等待换入的进程 (按进入队列的顺序)
+    uint32_t swapped_count;   // 映像在后备文件中的进程数 (含仍在等待I/O的)
+    uint32_t loading;         // 正在换入的进程下标 (PROC_NONE表示无)
+    uint32_t busy_until;      // 交换通道在该时间单位结束时空闲
+    swap_stats_t stats;
+    // swap_reclaim()的临时数组 (表很大时不放在栈上): 各分区可换出的占有者下标 (PROC_NONE表示不可换出) 及其代价
+    uint32_t reclaim_owner[MAX_PARTITIONS];
+    uint64_t reclaim_cost[MAX_PARTITIONS];
+} swap_state_t;
+
+// 开关、回收策略和后备文件的设置在kernel_init()后保留
+void swap_set_enabled(int enabled);
+int swap_get_enabled(void);
+void swap_set_policy(reclaim_policy_t policy);
+reclaim_policy_t swap_get_policy(void);
+const char* reclaim_policy_name(reclaim_policy_t policy);
+int swap_set_backing(const char* path);     // 关闭当前后备文件，下次换出时按新设置打开
+void swap_close(void);
+void swap_reset(void);
+int swap_make_room(process_t* proc);        // 为新到达的进程换出进程，腾出分区后返回1
+// 换出最少的进程，腾出至少size字节的空闲分区，成功返回1 (不要求交换已开启)
+// requester非NULL时只换出优先级比它低、驻留至少SWAP_MIN_RESIDENT的进程
+int swap_reclaim(uint32_t size, const process_t* requester);
+void swap_on_io_done(process_t* proc);      // 已换出的进程I/O完成
+void swap_cancel(process_t* proc);          // 把已换出或正在换入的进程移出交换队列
+void swap_tick(uint32_t now);               // 每个时间单位结束时完成换入并开始下一次换入
+int swap_write_image(uint32_t slot, const uint8_t* data, uint32_t size);
+int swap_read_image(uint32_t slot, uint8_t* data, uint32_t size);
+void swap_get_stats(swap_stats_t* stats);
+
+#endif // _SWAP_H
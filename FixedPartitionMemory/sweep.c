@@ -0,0 +1,321 @@
+// 多场景并行扫描：分配策略 x 调度算法 x 分区布局 x 随机种子
+// 每个工作线程绑定自己的内核上下文 (kernel_ctx_bind)，场景之间互不干扰；轨迹按种子预先生成，线程间只读共享
+// 编译: gcc -O2 -o sweep sweep.c sim.c init.c log.c kstring.c perf.c frag.c adapt.c physmem.c traffic.c io.c swap.c process.c partition.c memory.c scheduler.c compact.c snapshot.c -lpthread
+// 运行: ./sweep [--threads T] [--count N] [--seeds K] [--seed S] [--interarrival K] [--phase N]
+//               [--rt PCT] [--layouts default,FILE,...] [--adaptive] [--json] [--csv FILE]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+// <sched.h> 的 SCHED_FIFO/SCHED_RR 宏与 scheduler.h 的枚举同名
+#undef SCHED_FIFO
+#undef SCHED_RR
+#include "sim.h"
+#include "kernel.h"
+#include "bench_util.h"
+
+#define MAX_THREADS 256
+#define MAX_LAYOUTS 32
+#define MAX_LAYOUT (MAX_PARTITIONS - 1)
+
+static const allocation_strategy_t strategies[] = { FIRST_FIT, BEST_FIT, WORST_FIT };
+static const scheduler_type_t schedulers[] = { SCHED_FIFO, SCHED_RR, SCHED_PRIORITY, SCHED_EDF };
+#define STRATEGY_COUNT (sizeof(strategies) / sizeof(strategies[0]))
+#define SCHEDULER_COUNT (sizeof(schedulers) / sizeof(schedulers[0]))
+
+typedef struct layout_t {
+    const char* name;
+    uint32_t count;
+    uint32_t sizes[MAX_LAYOUT];
+} layout_t;
+
+// 一个场景及其结果摘要
+typedef struct scenario_t {
+    allocation_strategy_t strategy;
+    scheduler_type_t scheduler;
+    uint32_t layout;
+    uint32_t seed;        // 种子下标
+    int ok;
+    double wall_ms;
+    uint32_t completed;
+    uint32_t rejected;
+    uint32_t unfinished;
+    uint32_t ticks;
+    uint64_t events;
+    double avg_turnaround;
+    double avg_waiting;
+    double avg_admit_delay;
+    uint32_t p95_turnaround;
+    double cpu_util;
+    double mean_alloc_util;
+    double mean_internal_frag;
+    double mean_external_frag;
+    uint32_t rt_tasks;    // 带截止期的进程数及其中错过截止期的数量
+    uint32_t rt_misses;
+} scenario_t;
+
+static trace_t* traces;
+static uint32_t* trace_max_ticks;
+static uint32_t* seeds;
+static layout_t layouts[MAX_LAYOUTS];
+static uint32_t layout_count;
+static scenario_t* scenarios;
+static uint32_t scenario_count;
+static uint32_t next_scenario;    // 下一个待领取的场景 (原子递增)
+static int adaptive;
+
+static void run_scenario(scenario_t* s) {
+    const layout_t* l = &layouts[s->layout];
+    sim_config_t config;
+    sim_result_t r;
+
+    config.strategy = s->strategy;
+    config.scheduler = s->scheduler;
+    config.max_ticks = trace_max_ticks[s->seed];
+    config.sample_interval = 10;
+    config.adaptive = adaptive;
+    config.traffic = TRAFFIC_NONE;
+    config.traffic_accesses = 0;
+    config.traffic_stride = 0;
+    config.io_service_time = 0;
+    config.io_sched = IO_SCHED_FIFO;
+    config.swap = 0;
+    config.reclaim = RECLAIM_PRIORITY;
+
+    uint64_t t0 = bench_now_ns();
+    if (partition_set_layout(l->sizes, l->count) != 0 || sim_run(&traces[s->seed], &config, &r) != 0) {
+        s->ok = 0;
+        return;
+    }
+    s->wall_ms = (bench_now_ns() - t0) / 1e6;
+    s->ok = 1;
+    s->completed = r.completed;
+    s->rejected = r.rejected;
+    s->unfinished = r.unfinished;
+    s->ticks = r.ticks;
+    s->events = r.events;
+    s->avg_turnaround = r.avg_turnaround;
+    s->avg_waiting = r.avg_waiting;
+    s->avg_admit_delay = r.avg_admit_delay;
+    s->p95_turnaround = r.p95_turnaround;
+    s->cpu_util = r.ticks ? (double)r.busy_ticks / r.ticks : 0;
+    s->mean_alloc_util = r.mean_alloc_util;
+    s->mean_internal_frag = r.mean_internal_frag;
+    s->mean_external_frag = r.mean_external_frag;
+    s->rt_tasks = r.rt_tasks;
+    s->rt_misses = r.rt_misses;
+    sim_result_free(&r);
+}
+
+static void* worker_main(void* arg) {
+    kernel_ctx_t* ctx = kernel_ctx_create();
+    (void)arg;
+
+    if (!ctx) return NULL;
+    kernel_ctx_bind(ctx);
+    for (;;) {
+        uint32_t i = __atomic_fetch_add(&next_scenario, 1, __ATOMIC_RELAXED);
+        if (i >= scenario_count) break;
+        run_scenario(&scenarios[i]);
+    }
+    kernel_ctx_destroy(ctx);
+    return NULL;
+}
+
+// 解析 "default,a.txt,b.txt"，default 为预定义布局
+static int parse_layouts(char* list) {
+    for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        layout_t* l = &layouts[layout_count];
+        if (layout_count == MAX_LAYOUTS) {
+            fprintf(stderr, "too many layouts (max %d)\n", MAX_LAYOUTS);
+            return -1;
+        }
+        if (strcmp(name, "default") == 0) {
+            partition_set_layout(NULL, 0);
+        } else if (partition_load_layout(name) != 0) {
+            fprintf(stderr, "failed to load layout %s\n", name);
+            return -1;
+        }
+        l->name = name;
+        l->count = partition_get_layout(l->sizes, MAX_LAYOUT);
+        layout_count++;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    trace_params_t params;
+    char default_layouts[] = "default";
+    char* layout_list = default_layouts;
+    const char* csv_path = NULL;
+    uint32_t threads = 0;
+    uint32_t seed_count = 4;
+    int json = 0;
+
+    trace_default_params(&params);
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        char* v = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(a, "--json") == 0) { json = 1; continue; }
+        if (strcmp(a, "--adaptive") == 0) { adaptive = 1; continue; }
+        if (!v) { fprintf(stderr, "missing value for %s\n", a); return 1; }
+        if (strcmp(a, "--threads") == 0) threads = (uint32_t)atoi(v);
+        else if (strcmp(a, "--count") == 0) params.count = (uint32_t)atoi(v);
+        else if (strcmp(a, "--seeds") == 0) seed_count = (uint32_t)atoi(v);
+        else if (strcmp(a, "--seed") == 0) params.seed = (uint32_t)atoi(v);
+        else if (strcmp(a, "--interarrival") == 0) params.max_interarrival = (uint32_t)atoi(v);
+        else if (strcmp(a, "--phase") == 0) params.phase_length = (uint32_t)atoi(v);
+        else if (strcmp(a, "--rt") == 0) params.rt_percent = (uint32_t)atoi(v);
+        else if (strcmp(a, "--layouts") == 0) layout_list = v;
+        else if (strcmp(a, "--csv") == 0) csv_path = v;
+        else { fprintf(stderr, "unknown option %s\n", a); return 1; }
+        i++;
+    }
+    if (seed_count == 0) seed_count = 1;
+    if (threads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = n > 0 ? (uint32_t)n : 1;
+    }
+    if (threads > MAX_THREADS) threads = MAX_THREADS;
+
+    // 布局在主线程的默认上下文中解析
+    if (parse_layouts(layout_list) != 0 || layout_count == 0) {
+        return 1;
+    }
+
+    // 每个种子一条轨迹，所有场景只读共享
+    uint32_t base_seed = params.seed;
+    traces = (trace_t*)calloc(seed_count, sizeof(trace_t));
+    trace_max_ticks = (uint32_t*)calloc(seed_count, sizeof(uint32_t));
+    seeds = (uint32_t*)calloc(seed_count, sizeof(uint32_t));
+    if (!traces || !trace_max_ticks || !seeds) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    for (uint32_t k = 0; k < seed_count; k++) {
+        seeds[k] = params.seed = base_seed + k;
+        if (trace_generate(&traces[k], &params) != 0) {
+            fprintf(stderr, "failed to generate trace\n");
+            return 1;
+        }
+        const trace_t* t = &traces[k];
+        uint64_t total = t->count ? t->entries[t->count - 1].arrival_time : 0;
+        for (uint32_t i = 0; i < t->count; i++) total += t->entries[i].burst_time;
+        trace_max_ticks[k] = (uint32_t)(total + 1000 < 0xFFFFFFF0u ? total + 1000 : 0xFFFFFFF0u);
+    }
+
+    scenario_count = (uint32_t)(STRATEGY_COUNT * SCHEDULER_COUNT) * layout_count * seed_count;
+    scenarios = (scenario_t*)calloc(scenario_count, sizeof(scenario_t));
+    if (!scenarios) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    uint32_t n = 0;
+    for (uint32_t li = 0; li < layout_count; li++) {
+        for (uint32_t k = 0; k < seed_count; k++) {
+            for (uint32_t si = 0; si < STRATEGY_COUNT; si++) {
+                for (uint32_t ci = 0; ci < SCHEDULER_COUNT; ci++) {
+                    scenario_t* s = &scenarios[n++];
+                    s->strategy = strategies[si];
+                    s->scheduler = schedulers[ci];
+                    s->layout = li;
+                    s->seed = k;
+                }
+            }
+        }
+    }
+    if (threads > scenario_count) threads = scenario_count;
+
+    pthread_t pool[MAX_THREADS];
+    uint32_t started = 0;
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t t = 0; t < threads; t++) {
+        if (pthread_create(&pool[t], NULL, worker_main, NULL) != 0) break;
+        started++;
+    }
+    if (started == 0) {
+        // 无法创建线程时在主线程中执行
+        worker_main(NULL);
+    }
+    for (uint32_t t = 0; t < started; t++) {
+        pthread_join(pool[t], NULL);
+    }
+    double wall_ms = (bench_now_ns() - t0) / 1e6;
+
+    uint32_t failed = 0;
+    for (uint32_t i = 0; i < scenario_count; i++) {
+        if (!scenarios[i].ok) failed++;
+    }
+
+    FILE* csv = csv_path ? fopen(csv_path, "w") : NULL;
+    if (csv_path && !csv) {
+        fprintf(stderr, "failed to open %s\n", csv_path);
+    }
+    if (csv) {
+        fprintf(csv, "layout,seed,strategy,scheduler,ok,wall_ms,completed,rejected,unfinished,ticks,events,"
+            "avg_turnaround,avg_waiting,avg_admit_delay,p95_turnaround,cpu_util,mean_alloc_util,"
+            "mean_internal_frag,mean_external_frag,rt_tasks,rt_misses\n");
+    }
+    if (json) {
+        printf("{\"benchmark\":\"sweep\",\"threads\":%u,\"scenarios\":%u,\"failed\":%u,\"wall_ms\":%.3f,"
+            "\"scenarios_per_sec\":%.1f,\"results\":[\n", started ? started : 1, scenario_count, failed, wall_ms,
+            wall_ms > 0 ? scenario_count * 1e3 / wall_ms : 0);
+    } else {
+        printf("sweep: %u scenarios (%u layouts x %u seeds x %u strategies x %u schedulers), %u threads\n",
+            scenario_count, layout_count, seed_count, (uint32_t)STRATEGY_COUNT, (uint32_t)SCHEDULER_COUNT,
+            started ? started : 1);
+        printf("%-16s %6s %-10s %-9s %6s %5s %5s %8s %8s %8s %6s %5s %6s %6s %6s %5s\n",
+            "layout", "seed", "strategy", "scheduler", "done", "rej", "unfin", "turn", "wait", "admit",
+            "p95", "cpu%", "mem%", "ifrag%", "efrag%", "miss");
+    }
+
+    for (uint32_t i = 0; i < scenario_count; i++) {
+        const scenario_t* s = &scenarios[i];
+        const char* lname = layouts[s->layout].name;
+        const char* sname = sim_strategy_name(s->strategy);
+        const char* cname = sim_scheduler_name(s->scheduler);
+        uint32_t seed = seeds[s->seed];
+
+        if (json) {
+            printf("%s{\"layout\":\"%s\",\"seed\":%u,\"strategy\":\"%s\",\"scheduler\":\"%s\",\"ok\":%d,"
+                "\"wall_ms\":%.3f,\"completed\":%u,\"rejected\":%u,\"unfinished\":%u,\"ticks\":%u,\"events\":%llu,"
+                "\"avg_turnaround\":%.3f,\"avg_waiting\":%.3f,\"avg_admit_delay\":%.3f,\"p95_turnaround\":%u,"
+                "\"cpu_util\":%.4f,\"mean_alloc_util\":%.4f,\"mean_internal_frag\":%.4f,\"mean_external_frag\":%.4f,"
+                "\"rt_tasks\":%u,\"rt_misses\":%u}",
+                i ? ",\n" : "", lname, seed, sname, cname, s->ok, s->wall_ms, s->completed, s->rejected,
+                s->unfinished, s->ticks, (unsigned long long)s->events, s->avg_turnaround, s->avg_waiting,
+                s->avg_admit_delay, s->p95_turnaround, s->cpu_util, s->mean_alloc_util,
+                s->mean_internal_frag, s->mean_external_frag, s->rt_tasks, s->rt_misses);
+        } else if (s->ok) {
+            printf("%-16s %6u %-10s %-9s %6u %5u %5u %8.1f %8.1f %8.1f %6u %5.1f %6.1f %6.1f %6.1f %5u\n",
+                lname, seed, sname, cname, s->completed, s->rejected, s->unfinished, s->avg_turnaround,
+                s->avg_waiting, s->avg_admit_delay, s->p95_turnaround, s->cpu_util * 100,
+                s->mean_alloc_util * 100, s->mean_internal_frag * 100, s->mean_external_frag * 100, s->rt_misses);
+        } else {
+            printf("%-16s %6u %-10s %-9s failed\n", lname, seed, sname, cname);
+        }
+        if (csv) {
+            fprintf(csv, "%s,%u,%s,%s,%d,%.3f,%u,%u,%u,%u,%llu,%.3f,%.3f,%.3f,%u,%.4f,%.4f,%.4f,%.4f,%u,%u\n",
+                lname, seed, sname, cname, s->ok, s->wall_ms, s->completed, s->rejected, s->unfinished,
+                s->ticks, (unsigned long long)s->events, s->avg_turnaround, s->avg_waiting, s->avg_admit_delay,
+                s->p95_turnaround, s->cpu_util, s->mean_alloc_util, s->mean_internal_frag, s->mean_external_frag,
+                s->rt_tasks, s->rt_misses);
+        }
+    }
+
+    if (json) {
+        printf("\n]}\n");
+    } else {
+        printf("wall %.1f ms, %.1f scenarios/s%s\n", wall_ms, wall_ms > 0 ? scenario_count * 1e3 / wall_ms : 0,
+            failed ? ", some scenarios failed" : "");
+    }
+
+    if (csv) fclose(csv);
+    for (uint32_t k = 0; k < seed_count; k++) trace_free(&traces[k]);
+    free(traces);
+    free(trace_max_ticks);
+    free(seeds);
+    free(scenarios);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,56 @@
+#ifndef _TAGSTACK_H
+#define _TAGSTACK_H
+
+#include <stdint.h>
+
+// 无锁下标栈 (Treiber栈)
+// 栈顶是一个64位字: 高32位为版本号，低32位为栈顶元素的下标 (TAG_STACK_EMPTY表示空)，
+// 元素经调用者提供的 next[] 数组链接。每次成功的压入/弹出都把版本号加1，元素被弹出又压回后，
+// 持有旧栈顶的线程CAS必然失败，因此没有ABA问题；弹出时读到的next[]可能已过时，但这时CAS也会失败。
+// 元素从弹出到压回之间只属于弹出它的线程。retries累加CAS失败次数 (可为NULL)
+#define TAG_STACK_EMPTY 0xFFFFFFFFu
+
+// 每个栈顶独占一个缓存行，不同栈之间没有伪共享
+typedef struct tag_stack_t {
+    uint64_t head;
+    uint8_t pad[56];
+} tag_stack_t;
+
+static inline void tag_stack_init(tag_stack_t* s) {
+    __atomic_store_n(&s->head, (uint64_t)TAG_STACK_EMPTY, __ATOMIC_RELAXED);
+}
+
+// 弹出栈顶元素，空栈返回TAG_STACK_EMPTY
+static inline uint32_t tag_stack_pop(tag_stack_t* s, uint32_t* next, uint64_t* retries) {
+    uint64_t old = __atomic_load_n(&s->head, __ATOMIC_ACQUIRE);
+    for (;;) {
+        uint32_t top = (uint32_t)old;
+        if (top == TAG_STACK_EMPTY) return TAG_STACK_EMPTY;
+
+        uint64_t tag = (old >> 32) + 1;
+        uint64_t want = tag << 32 | __atomic_load_n(&next[top], __ATOMIC_RELAXED);
+        if (__atomic_compare_exchange_n(&s->head, &old, want, 1, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+            return top;
+        }
+        if (retries) (*retries)++;
+    }
+}
+
+// 一次CAS压入已经由next[]从first链接到last的一串元素
+static inline void tag_stack_push_chain(tag_stack_t* s, uint32_t* next, uint32_t first, uint32_t last, uint64_t* retries) {
+    uint64_t old = __atomic_load_n(&s->head, __ATOMIC_RELAXED);
+    for (;;) {
+        __atomic_store_n(&next[last], (uint32_t)old, __ATOMIC_RELAXED);
+        uint64_t want = ((old >> 32) + 1) << 32 | first;
+        if (__atomic_compare_exchange_n(&s->head, &old, want, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            return;
+        }
+        if (retries) (*retries)++;
+    }
+}
+
+static inline void tag_stack_push(tag_stack_t* s, uint32_t* next, uint32_t i, uint64_t* retries) {
+    tag_stack_push_chain(s, next, i, i, retries);
+}
+
+#endif // _TAGSTACK_H
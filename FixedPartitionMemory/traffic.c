@@ -0,0 +1,143 @@
+#include "os_types.h"
+#include "config.h"
+#include "log.h"
+#include "kernel.h"
+#include "perf.h"
+#include "traffic.h"
+
+// 访存模型状态位于当前内核上下文
+#define TRAFFIC (kernel_ctx_current()->traffic)
+
+// 进程映像在偏移off处的字节
+static inline uint8_t image_byte(uint32_t pid, uint32_t off) {
+    return (uint8_t)(pid * 167u + off * 31u + 7u);
+}
+
+static uint32_t rng_next(void) {
+    uint32_t x = TRAFFIC.rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return TRAFFIC.rng = x;
+}
+
+void traffic_set_pattern(traffic_pattern_t p, uint32_t accesses, uint32_t step) {
+    TRAFFIC.pattern = p;
+    TRAFFIC.accesses_per_tick = accesses ? accesses : TRAFFIC_ACCESSES_PER_TICK;
+    TRAFFIC.stride = step ? step : TRAFFIC_STRIDE;
+}
+
+traffic_pattern_t traffic_get_pattern(void) {
+    return TRAFFIC.pattern;
+}
+
+void traffic_reset(void) {
+    memset(TRAFFIC.cursor, 0, sizeof(TRAFFIC.cursor));
+    memset(&TRAFFIC.stats, 0, sizeof(TRAFFIC.stats));
+    TRAFFIC.rng = 0x2545F491u;
+}
+
+// 校验 [start, start+size) 是否为pid的映像，返回不符的字节数
+static uint32_t verify_image(uint32_t pid, uint32_t start, uint32_t size) {
+    const uint8_t* base = get_memory_base() + start;
+    uint32_t bad = 0;
+    for (uint32_t off = 0; off < size; off++) {
+        bad += base[off] != image_byte(pid, off);
+    }
+    return bad;
+}
+
+void traffic_on_allocate(const partition_t* part) {
+    if (TRAFFIC.pattern == TRAFFIC_NONE) return;
+
+    uint8_t* base = get_memory_base() + part->start;
+    for (uint32_t off = 0; off < part->used_size; off++) {
+        base[off] = image_byte(part->owner_pid, off);
+    }
+}
+
+void traffic_on_free(const partition_t* part) {
+    if (TRAFFIC.pattern == TRAFFIC_NONE) return;
+
+    uint32_t bad = verify_image(part->owner_pid, part->start, part->used_size);
+    TRAFFIC.stats.verified_bytes += part->used_size;
+    if (bad) {
+        TRAFFIC.stats.corruptions += bad;
+        kernel_log(LOG_WARNING, "Traffic: PID=%d image corrupted (%d of %d bytes)",
+            part->owner_pid, bad, part->used_size);
+    }
+}
+
+// 进程占有的分区，与进程记录的地址范围不一致时返回NULL；
+// 通过检查后进程映像 [0, memory_size) 必在分区内，访问时不再逐次检查边界
+static const partition_t* owner_partition(const process_t* proc) {
+    const process_info_t* info = process_info(proc);
+    for (uint32_t i = 1; i < partition_count; i++) {
+        const partition_t* part = &partition_table[i];
+        if (part->start != info->memory_start) continue;
+        if (part->state != PARTITION_ALLOCATED || part->owner_pid != proc->pid ||
+            info->memory_end != part->start + part->size - 1 || proc->memory_size > part->size) {
+            return NULL;
+        }
+        return part;
+    }
+    return NULL;
+}
+
+void traffic_run(process_t* proc) {
+    if (TRAFFIC.pattern == TRAFFIC_NONE || !proc || proc->memory_size == 0) return;
+
+    PERF_BEGIN();
+    const partition_t* part = owner_partition(proc);
+    if (!part) {
+        TRAFFIC.stats.violations += TRAFFIC.accesses_per_tick;
+        kernel_log(LOG_ERR, "Traffic: PID=%d range 0x%x-0x%x is not its partition",
+            proc->pid, process_info(proc)->memory_start, process_info(proc)->memory_end);
+        PERF_END(PERF_TRAFFIC);
+        return;
+    }
+
+    uint8_t* base = get_memory_base() + part->start;
+    uint32_t size = proc->memory_size;
+    uint32_t slot = (uint32_t)(proc - process_table);
+    uint32_t pos = TRAFFIC.cursor[slot] < size ? TRAFFIC.cursor[slot] : 0;
+    uint32_t bad = 0;
+
+    for (uint32_t i = 0; i < TRAFFIC.accesses_per_tick; i++) {
+        uint32_t off;
+        switch (TRAFFIC.pattern) {
+            case TRAFFIC_SEQUENTIAL:
+                off = pos;
+                pos = pos + 1 < size ? pos + 1 : 0;
+                break;
+            case TRAFFIC_STRIDED:
+                off = pos;
+                pos = (pos + TRAFFIC.stride) % size;
+                break;
+            default:
+                off = rng_next() % size;
+                break;
+        }
+        uint8_t want = image_byte(proc->pid, off);
+        bad += base[off] != want;
+        base[off] = want;
+    }
+    TRAFFIC.cursor[slot] = pos;
+    TRAFFIC.stats.accesses += TRAFFIC.accesses_per_tick;
+    TRAFFIC.stats.corruptions += bad;
+    PERF_END(PERF_TRAFFIC);
+}
+
+void traffic_get_stats(traffic_stats_t* out) {
+    *out = TRAFFIC.stats;
+}
+
+const char* traffic_pattern_name(traffic_pattern_t p) {
+    switch (p) {
+        case TRAFFIC_NONE: return "none";
+        case TRAFFIC_SEQUENTIAL: return "seq";
+        case TRAFFIC_STRIDED: return "stride";
+        case TRAFFIC_RANDOM: return "random";
+        default: return "unknown";
+    }
+}
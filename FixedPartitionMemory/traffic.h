@@ -0,0 +1,48 @@
+#ifndef _TRAFFIC_H
+#define _TRAFFIC_H
+
+#include "os_types.h"
+#include "config.h"
+#include "process.h"
+#include "partition.h"
+
+// 进程访存模型 (可选)
+// 分配时在分区中写入进程映像 (字节值由PID和偏移决定)，运行中的进程每个时间单位按访问模式读写映像，
+// 每个时间单位先检查进程记录的地址范围与它持有的分区一致 (映像因此整个在分区内)，再逐次校验内容；
+// 释放时校验整个映像。
+// 用于测量分区位置带来的缓存效应，并验证重定位/紧凑后进程数据不变
+typedef enum {
+    TRAFFIC_NONE,         // 关闭 (默认)，进程不访问内存
+    TRAFFIC_SEQUENTIAL,   // 顺序访问，到末尾后回绕
+    TRAFFIC_STRIDED,      // 固定步长访问
+    TRAFFIC_RANDOM        // 均匀随机访问
+} traffic_pattern_t;
+
+typedef struct traffic_stats_t {
+    uint64_t accesses;        // 读改写次数
+    uint64_t verified_bytes;  // 释放时校验的映像字节数
+    uint64_t corruptions;     // 内容与映像不符的字节数
+    uint64_t violations;      // 地址范围与分区不符的时间单位中被跳过的访问次数 (整个时间单位跳过)
+} traffic_stats_t;
+
+// 访存模型状态 (每个内核上下文一份)
+typedef struct traffic_state_t {
+    traffic_pattern_t pattern;
+    uint32_t accesses_per_tick;
+    uint32_t stride;
+    uint32_t rng;
+    uint32_t cursor[MAX_PROCESSES];   // 每个进程表槽位的下一访问偏移
+    traffic_stats_t stats;
+} traffic_state_t;
+
+// 设置访问模式，下次kernel_init()后的进程使用 (accesses/stride为0时取config.h默认值)
+void traffic_set_pattern(traffic_pattern_t pattern, uint32_t accesses_per_tick, uint32_t stride);
+traffic_pattern_t traffic_get_pattern(void);
+void traffic_reset(void);
+void traffic_on_allocate(const partition_t* part);
+void traffic_on_free(const partition_t* part);
+void traffic_run(process_t* proc);   // 运行中的进程执行一个时间单位的访问
+void traffic_get_stats(traffic_stats_t* stats);
+const char* traffic_pattern_name(traffic_pattern_t pattern);
+
+#endif // _TRAFFIC_H